@@ -0,0 +1,209 @@
+#define SUDOKU_COMPILANDO
+#include "BibliotecaSudoku.h"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <new>
+#include <algorithm>
+
+#include "MotoresSudoku.h"
+#include "LectorSudokus.h"
+#include "ValidadorBits.h"
+
+using namespace std;
+
+namespace {
+
+/**
+ * Reparte los índices 0..cantidad-1 entre 'hilos' hilos que los toman de
+ * un contador compartido (los tableros difíciles no frenan a los demás).
+ * Con un hilo se trabaja en el del llamador. Las excepciones de los
+ * hilos se relanzan en el llamador.
+ */
+template <typename Funcion>
+void repartir(size_t cantidad, int hilos, Funcion procesar) {
+    if (hilos <= 0) hilos = max(1u, thread::hardware_concurrency());
+    hilos = (int)min<size_t>(hilos, cantidad);
+    if (hilos <= 1) {
+        for (size_t k = 0; k < cantidad; k++) {
+            procesar(0, k);
+        }
+        return;
+    }
+
+    atomic<size_t> siguiente(0);
+    vector<exception_ptr> errores(hilos);
+    vector<thread> trabajadores;
+    for (int h = 0; h < hilos; h++) {
+        trabajadores.emplace_back([&, h]() {
+            try {
+                for (size_t k = siguiente++; k < cantidad; k = siguiente++) {
+                    procesar(h, k);
+                }
+            } catch (...) {
+                errores[h] = current_exception();
+                siguiente = cantidad;
+            }
+        });
+    }
+    for (auto& t : trabajadores) {
+        t.join();
+    }
+    for (auto& e : errores) {
+        if (e) rethrow_exception(e);
+    }
+}
+
+template <typename Funcion>
+long long sinExcepciones(Funcion llamada) {
+    try {
+        return llamada();
+    } catch (const invalid_argument&) {
+        return SUDOKU_ERROR_ARGUMENTOS;
+    } catch (...) {
+        return SUDOKU_ERROR_INTERNO;
+    }
+}
+
+bool ordenValido(int n) {
+    return n >= 2 && n <= 10;
+}
+
+}
+
+void sudoku_opciones_por_defecto(sudoku_opciones* opciones) {
+    if (!opciones) return;
+    opciones->motor = SUDOKU_MOTOR_HIBRIDO;
+    opciones->hilos = 0;
+    opciones->limite_segundos = 0;
+    opciones->limite_nodos = 0;
+}
+
+long long sudoku_resolver_lote(int* tableros, size_t cantidad, int n,
+                               const sudoku_opciones* opciones, int* resultados) {
+    if (cantidad == 0) return 0;
+    if (!tableros || !resultados || !ordenValido(n)) return SUDOKU_ERROR_ARGUMENTOS;
+
+    sudoku_opciones elegidas;
+    sudoku_opciones_por_defecto(&elegidas);
+    if (opciones) elegidas = *opciones;
+    if (elegidas.motor != SUDOKU_MOTOR_HIBRIDO && elegidas.motor != SUDOKU_MOTOR_DLX) {
+        return SUDOKU_ERROR_ARGUMENTOS;
+    }
+
+    return sinExcepciones([&]() -> long long {
+        LimitesBusqueda limites;
+        limites.segundos = elegidas.limite_segundos;
+        limites.nodos = elegidas.limite_nodos;
+        string motor = elegidas.motor == SUDOKU_MOTOR_DLX ? "dlx" : "hibrido";
+
+        // Un resolvedor por hilo, creado al tomar su primer tablero
+        int hilos = elegidas.hilos > 0 ? elegidas.hilos : (int)max(1u, thread::hardware_concurrency());
+        vector<unique_ptr<ResolvedorSudoku>> resolvedores(hilos);
+        atomic<long long> resueltos(0);
+        size_t celdas = (size_t)n * n * n * n;
+
+        repartir(cantidad, hilos, [&](int h, size_t k) {
+            int* tablero = tableros + k * celdas;
+
+            // Pistas fuera de rango o repetidas se deciden sin buscar
+            ErrorTablero error = validarTableroPlano(tablero, n);
+            if (error == ERROR_RANGO) {
+                resultados[k] = SUDOKU_INVALIDO;
+                return;
+            }
+            if (error != TABLERO_VALIDO) {
+                resultados[k] = SUDOKU_SIN_SOLUCION;
+                return;
+            }
+
+            if (!resolvedores[h]) {
+                resolvedores[h] = crearResolvedor(motor, TecnicasPropagacion(), 1, false, limites);
+            }
+            ResolvedorSudoku& resolvedor = *resolvedores[h];
+            resolvedor.cargarSudoku(tablero, n);
+            if (resolvedor.resolverSudoku()) {
+                resolvedor.copiarSolucion(tablero);
+                resultados[k] = SUDOKU_RESUELTO;
+                resueltos++;
+            } else {
+                resultados[k] = resolvedor.limiteAgotado() ? SUDOKU_TIEMPO_AGOTADO : SUDOKU_SIN_SOLUCION;
+            }
+        });
+
+        return resueltos.load();
+    });
+}
+
+long long sudoku_validar_lote(const int* tableros, const int* entradas, size_t cantidad,
+                              int n, int hilos, int* resultados) {
+    if (cantidad == 0) return 0;
+    if (!tableros || !resultados || !ordenValido(n)) return SUDOKU_ERROR_ARGUMENTOS;
+
+    return sinExcepciones([&]() -> long long {
+        atomic<long long> validos(0);
+        size_t celdas = (size_t)n * n * n * n;
+
+        repartir(cantidad, hilos, [&](int, size_t k) {
+            const int* tablero = tableros + k * celdas;
+            static const int codigos[] = {
+                SUDOKU_VALIDO, SUDOKU_ERROR_RANGO, SUDOKU_ERROR_FILA,
+                SUDOKU_ERROR_COLUMNA, SUDOKU_ERROR_SUBCUADRADO
+            };
+
+            // Mismo orden que Validar: las pistas antes que las celdas vacías
+            int codigo = codigos[validarTableroPlano(tablero, n)];
+            if (codigo == SUDOKU_VALIDO && entradas) {
+                const int* entrada = entradas + k * celdas;
+                for (size_t c = 0; c < celdas; c++) {
+                    if (entrada[c] != 0 && entrada[c] != tablero[c]) {
+                        codigo = SUDOKU_PISTAS_ALTERADAS;
+                        break;
+                    }
+                }
+            }
+            if (codigo == SUDOKU_VALIDO && find(tablero, tablero + celdas, 0) != tablero + celdas) {
+                codigo = SUDOKU_INCOMPLETO;
+            }
+
+            resultados[k] = codigo;
+            validos += codigo == SUDOKU_VALIDO;
+        });
+
+        return validos.load();
+    });
+}
+
+long long sudoku_leer(const char* datos, size_t largo, int n, int* tableros, size_t maximo) {
+    if ((!datos && largo > 0) || (!tableros && maximo > 0) || !ordenValido(n)) {
+        return SUDOKU_ERROR_ARGUMENTOS;
+    }
+
+    return sinExcepciones([&]() -> long long {
+        // Los bloques de dimensiones inválidas llegan con n = 0 y se saltan
+        // sin escribir avisos en el stderr del proceso anfitrión
+        LectorSudokus lector;
+        lector.configurarInvalidos(true);
+        size_t celdas = (size_t)n * n * n * n;
+        long long encontrados = 0;
+
+        // Un binario dañado lanza runtime_error; se informa como argumento inválido
+        try {
+            lector.leerBufer(datos, largo, [&](const TableroPlano& sudoku) {
+                if (sudoku.n != n) return;
+                if ((size_t)encontrados < maximo) {
+                    copy(sudoku.celdas, sudoku.celdas + celdas, tableros + encontrados * celdas);
+                }
+                encontrados++;
+            });
+        } catch (const runtime_error&) {
+            throw invalid_argument("datos");
+        }
+
+        return encontrados;
+    });
+}
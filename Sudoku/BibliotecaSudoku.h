@@ -0,0 +1,114 @@
+#ifndef BIBLIOTECA_SUDOKU_H
+#define BIBLIOTECA_SUDOKU_H
+
+/*
+ * Interfaz C de la biblioteca de sudokus (BibliotecaSudoku.cpp), para
+ * usar el resolvedor, el lector y el validador dentro de otro proceso.
+ *
+ * Los tableros son arreglos contiguos de int: cada uno ocupa n^4 celdas
+ * por filas (fila * n² + columna), con 0 para las vacías, y el tablero k
+ * empieza en tableros + k * n^4. Las funciones de lote trabajan sobre el
+ * arreglo del llamador sin copiarlo y devuelven un código por tablero.
+ *
+ * Todas las funciones son seguras entre hilos y no lanzan excepciones:
+ * los errores de argumentos o de memoria se devuelven como códigos
+ * negativos (SUDOKU_ERROR_*).
+ */
+
+#include <stddef.h>
+
+#if defined(_WIN32) && defined(SUDOKU_DLL)
+#  ifdef SUDOKU_COMPILANDO
+#    define SUDOKU_API __declspec(dllexport)
+#  else
+#    define SUDOKU_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define SUDOKU_API __attribute__((visibility("default")))
+#else
+#  define SUDOKU_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Resultado de un tablero en sudoku_resolver_lote */
+enum {
+    SUDOKU_RESUELTO = 0,
+    SUDOKU_SIN_SOLUCION = 1,      /* incluye pistas repetidas en una unidad */
+    SUDOKU_TIEMPO_AGOTADO = 2,    /* el tablero queda como estaba */
+    SUDOKU_INVALIDO = 3           /* algún valor fuera de [0, n²] */
+};
+
+/* Resultado de un tablero en sudoku_validar_lote */
+enum {
+    SUDOKU_VALIDO = 0,
+    SUDOKU_ERROR_RANGO = 1,
+    SUDOKU_ERROR_FILA = 2,
+    SUDOKU_ERROR_COLUMNA = 3,
+    SUDOKU_ERROR_SUBCUADRADO = 4,
+    SUDOKU_INCOMPLETO = 5,
+    SUDOKU_PISTAS_ALTERADAS = 6
+};
+
+/* Errores de llamada (valor de retorno negativo) */
+enum {
+    SUDOKU_ERROR_ARGUMENTOS = -1,  /* n fuera de 2..10, punteros nulos, motor desconocido */
+    SUDOKU_ERROR_INTERNO = -2      /* sin memoria o sin hilos */
+};
+
+/* Motores de resolución */
+enum {
+    SUDOKU_MOTOR_HIBRIDO = 0,
+    SUDOKU_MOTOR_DLX = 1
+};
+
+/*
+ * Opciones de resolución; sudoku_opciones_por_defecto las inicializa
+ * (motor híbrido, un hilo por núcleo, sin límites)
+ */
+typedef struct {
+    int motor;
+    int hilos;                 /* 0 = un hilo por núcleo */
+    double limite_segundos;    /* por tablero; 0 = sin límite */
+    long long limite_nodos;    /* por tablero; 0 = sin límite */
+} sudoku_opciones;
+
+SUDOKU_API void sudoku_opciones_por_defecto(sudoku_opciones* opciones);
+
+/*
+ * Resuelve 'cantidad' tableros de orden n (n² x n² celdas) en su sitio:
+ * cada tablero resuelto se sobrescribe con su solución. 'resultados'
+ * recibe un código SUDOKU_RESUELTO..SUDOKU_INVALIDO por tablero.
+ * 'opciones' puede ser NULL. Devuelve cuántos se resolvieron o un error
+ * negativo.
+ */
+SUDOKU_API long long sudoku_resolver_lote(int* tableros, size_t cantidad, int n,
+                                          const sudoku_opciones* opciones, int* resultados);
+
+/*
+ * Valida 'cantidad' tableros de orden n con 'hilos' hilos (0 = uno por
+ * núcleo). Si 'entradas' no es NULL, tiene la misma forma que 'tableros'
+ * y se comprueba además que cada tablero conserve sus pistas; como en
+ * Validar, las pistas alteradas se informan antes que las celdas vacías.
+ * Devuelve cuántos son válidos o un error negativo.
+ */
+SUDOKU_API long long sudoku_validar_lote(const int* tableros, const int* entradas, size_t cantidad,
+                                         int n, int hilos, int* resultados);
+
+/*
+ * Lee los tableros de orden n de un búfer en el formato de texto
+ * etiquetado o en el binario (.sdkb) y copia hasta 'maximo' en
+ * 'tableros'. Los bloques de otro orden, sin tablero o de dimensiones
+ * inválidas se saltan sin aviso.
+ * Devuelve cuántos tableros de orden n contiene el búfer (llamar con
+ * maximo = 0 para dimensionar) o un error negativo.
+ */
+SUDOKU_API long long sudoku_leer(const char* datos, size_t largo, int n, int* tableros, size_t maximo);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
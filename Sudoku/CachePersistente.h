@@ -0,0 +1,574 @@
+#ifndef CACHE_PERSISTENTE_H
+#define CACHE_PERSISTENTE_H
+
+#include <fstream>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "FormatoBinario.h"
+#include "ValidadorBits.h"
+
+using namespace std;
+
+/**
+ * Archivo proyectado en memoria de lectura y escritura que puede cambiar
+ * de tamaño (mmap compartido o CreateFileMapping según la plataforma).
+ * Se crea vacío si no existe.
+ */
+class ArchivoMapeadoEscritura {
+private:
+    char* datos = nullptr;
+    size_t tamanoBytes = 0;
+    string ruta;
+#ifdef _WIN32
+    HANDLE archivo = INVALID_HANDLE_VALUE;
+    HANDLE mapeo = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    void mapear() {
+        if (tamanoBytes == 0) return;
+#ifdef _WIN32
+        mapeo = CreateFileMappingA(archivo, nullptr, PAGE_READWRITE, 0, 0, nullptr);
+        if (mapeo != nullptr) {
+            datos = (char*)MapViewOfFile(mapeo, FILE_MAP_WRITE, 0, 0, 0);
+        }
+#else
+        void* p = mmap(nullptr, tamanoBytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        datos = p == MAP_FAILED ? nullptr : (char*)p;
+#endif
+        if (datos == nullptr) {
+            throw runtime_error("No se pudo mapear el archivo: " + ruta);
+        }
+    }
+
+    void desmapear() {
+#ifdef _WIN32
+        if (datos) UnmapViewOfFile(datos);
+        if (mapeo) CloseHandle(mapeo);
+        mapeo = nullptr;
+#else
+        if (datos) munmap(datos, tamanoBytes);
+#endif
+        datos = nullptr;
+    }
+
+public:
+    explicit ArchivoMapeadoEscritura(const string& rutaArchivo) : ruta(rutaArchivo) {
+#ifdef _WIN32
+        archivo = CreateFileA(ruta.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (archivo == INVALID_HANDLE_VALUE) {
+            throw runtime_error("No se pudo abrir el archivo: " + ruta);
+        }
+        LARGE_INTEGER largo;
+        GetFileSizeEx(archivo, &largo);
+        tamanoBytes = (size_t)largo.QuadPart;
+#else
+        fd = open(ruta.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) {
+            throw runtime_error("No se pudo abrir el archivo: " + ruta);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw runtime_error("No se pudo abrir el archivo: " + ruta);
+        }
+        tamanoBytes = (size_t)info.st_size;
+#endif
+        mapear();
+    }
+
+    ~ArchivoMapeadoEscritura() {
+        desmapear();
+#ifdef _WIN32
+        if (archivo != INVALID_HANDLE_VALUE) CloseHandle(archivo);
+#else
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    ArchivoMapeadoEscritura(const ArchivoMapeadoEscritura&) = delete;
+    ArchivoMapeadoEscritura& operator=(const ArchivoMapeadoEscritura&) = delete;
+
+    /**
+     * Cambia el tamaño del archivo y lo vuelve a mapear; los punteros
+     * anteriores dejan de ser válidos. Los bytes nuevos valen 0.
+     */
+    void redimensionar(size_t bytes) {
+        desmapear();
+#ifdef _WIN32
+        LARGE_INTEGER largo;
+        largo.QuadPart = (LONGLONG)bytes;
+        bool correcto = SetFilePointerEx(archivo, largo, nullptr, FILE_BEGIN) && SetEndOfFile(archivo);
+#else
+        bool correcto = ftruncate(fd, (off_t)bytes) == 0;
+#endif
+        if (!correcto) {
+            throw runtime_error("No se pudo redimensionar el archivo: " + ruta);
+        }
+        tamanoBytes = bytes;
+        mapear();
+    }
+
+    char* inicio() { return datos; }
+    size_t tamano() const { return tamanoBytes; }
+};
+
+/**
+ * Caché de soluciones en disco que persiste entre ejecuciones, indexada
+ * por un hash de 128 bits del tablero (orden y celdas). Es segura entre
+ * los hilos de un mismo proceso: todas las operaciones toman un mutex.
+ * Todos los enteros son little-endian.
+ *
+ *   Registro (archivo 'ruta'), solo se añade al final:
+ *     "SDKC" + uint32 version       cabecera del archivo, una vez
+ *     uint64 hash bajo, uint64 hash alto
+ *     uint8  n
+ *     uint8  resuelto               0 = sin solución
+ *     solución empaquetada como en FormatoBinario.h (solo si resuelto)
+ *
+ *   Índice ('ruta'.idx), proyectado en memoria:
+ *     "SDKI" + uint32 version
+ *     uint64 capacidad              ranuras, potencia de 2
+ *     uint64 ocupadas
+ *     uint64 largoRegistro          bytes del registro que cubre el índice
+ *     ranuras de 24 bytes: hash bajo, hash alto, desplazamiento (0 = libre)
+ *
+ * Si el índice falta, está dañado o no cubre el registro entero (p. ej.
+ * el proceso murió entre añadir un registro y actualizar el índice), se
+ * reconstruye recorriendo el registro, que además se recorta hasta el
+ * último registro completo. Solo se guardan tableros de orden 2..10; las
+ * entradas de otro orden que haya en el registro se saltan.
+ *
+ * Al superar 'maximoBytes' el registro se compacta: se reescribe con los
+ * registros más recientes que quepan en la mitad del máximo.
+ */
+class CachePersistente {
+private:
+    static constexpr char FIRMA_REGISTRO[4] = { 'S', 'D', 'K', 'C' };
+    static constexpr char FIRMA_INDICE[4] = { 'S', 'D', 'K', 'I' };
+    static const uint32_t VERSION = 1;
+    static const size_t CABECERA_REGISTRO = 8;
+    static const size_t CABECERA_INDICE = 32;
+    static const size_t TAMANO_RANURA = 24;
+    static const size_t CAPACIDAD_INICIAL = 1024;
+    static const size_t CABECERA_ENTRADA = 18;
+    static const int ORDEN_MINIMO = 2;
+    static const int ORDEN_MAXIMO = 10;
+
+    string ruta;
+    uint64_t maximoBytes;
+    mutable mutex mtx;
+    fstream registro;
+    uint64_t largoRegistro = 0;
+    unique_ptr<ArchivoMapeadoEscritura> indice;
+
+    size_t consultas = 0;
+    size_t aciertos = 0;
+    size_t compactaciones = 0;
+
+    // Búferes reutilizados bajo el mutex
+    string entrada;
+    vector<int> decodificadas;
+
+    static void escribirEntero(char* p, uint64_t valor, int bytes) {
+        for (int i = 0; i < bytes; i++) {
+            p[i] = (char)(valor >> (8 * i));
+        }
+    }
+
+    static void anadirEntero(string& destino, uint64_t valor, int bytes) {
+        for (int i = 0; i < bytes; i++) {
+            destino.push_back((char)(valor >> (8 * i)));
+        }
+    }
+
+    static uint64_t mezclar(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Dos cadenas de mezcla independientes dan los 128 bits
+    static void calcularHash(const int* celdas, int n, uint64_t& bajo, uint64_t& alto) {
+        int total = n * n * n * n;
+        bajo = mezclar(0x243F6A8885A308D3ULL ^ (uint64_t)n);
+        alto = mezclar(0x13198A2E03707344ULL + (uint64_t)n);
+        for (int k = 0; k < total; k++) {
+            uint64_t valor = (uint64_t)(uint32_t)celdas[k];
+            bajo = mezclar(bajo + 0x9E3779B97F4A7C15ULL + valor);
+            alto = mezclar((alto ^ (valor << 32 | (uint64_t)k)) + 0xD1B54A32D192ED03ULL);
+        }
+    }
+
+    static bool ordenAdmitido(int n) {
+        return n >= ORDEN_MINIMO && n <= ORDEN_MAXIMO;
+    }
+
+    static size_t largoEntrada(int n, bool resuelto) {
+        return CABECERA_ENTRADA + (resuelto ? bytesCeldas(n) : 0);
+    }
+
+    uint64_t capacidad() {
+        return leerEntero(indice->inicio() + 8, 8);
+    }
+
+    char* ranura(uint64_t i) {
+        return indice->inicio() + CABECERA_INDICE + i * TAMANO_RANURA;
+    }
+
+    /**
+     * Ranura con ese hash o la primera libre de su secuencia de sondeo
+     */
+    char* buscarRanura(uint64_t bajo, uint64_t alto) {
+        uint64_t mascara = capacidad() - 1;
+        for (uint64_t i = bajo & mascara;; i = (i + 1) & mascara) {
+            char* r = ranura(i);
+            if (leerEntero(r + 16, 8) == 0) return r;
+            if (leerEntero(r, 8) == bajo && leerEntero(r + 8, 8) == alto) return r;
+        }
+    }
+
+    void crearIndice(uint64_t capacidadNueva) {
+        indice->redimensionar(0);
+        indice->redimensionar(CABECERA_INDICE + capacidadNueva * TAMANO_RANURA);
+        char* p = indice->inicio();
+        memcpy(p, FIRMA_INDICE, 4);
+        escribirEntero(p + 4, VERSION, 4);
+        escribirEntero(p + 8, capacidadNueva, 8);
+        escribirEntero(p + 16, 0, 8);
+        escribirEntero(p + 24, 0, 8);
+    }
+
+    void insertarEnIndice(uint64_t bajo, uint64_t alto, uint64_t desplazamiento) {
+        char* cabecera = indice->inicio();
+        uint64_t ocupadas = leerEntero(cabecera + 16, 8);
+
+        // Factor de carga máximo 0,7: al crecer se reinsertan todas las ranuras
+        if ((ocupadas + 1) * 10 > capacidad() * 7) {
+            vector<uint64_t> entradas;
+            for (uint64_t i = 0; i < capacidad(); i++) {
+                char* r = ranura(i);
+                if (leerEntero(r + 16, 8) == 0) continue;
+                entradas.push_back(leerEntero(r, 8));
+                entradas.push_back(leerEntero(r + 8, 8));
+                entradas.push_back(leerEntero(r + 16, 8));
+            }
+            crearIndice(2 * capacidad());
+            ocupadas = 0;
+            for (size_t k = 0; k < entradas.size(); k += 3) {
+                char* r = buscarRanura(entradas[k], entradas[k + 1]);
+                escribirEntero(r, entradas[k], 8);
+                escribirEntero(r + 8, entradas[k + 1], 8);
+                escribirEntero(r + 16, entradas[k + 2], 8);
+                ocupadas++;
+            }
+            cabecera = indice->inicio();
+        }
+
+        char* r = buscarRanura(bajo, alto);
+        if (leerEntero(r + 16, 8) == 0) ocupadas++;
+        escribirEntero(r, bajo, 8);
+        escribirEntero(r + 8, alto, 8);
+        escribirEntero(r + 16, desplazamiento, 8);
+        escribirEntero(cabecera + 16, ocupadas, 8);
+    }
+
+    bool indiceValido() {
+        size_t largo = indice->tamano();
+        if (largo < CABECERA_INDICE) return false;
+        const char* p = indice->inicio();
+        uint64_t capacidadIndice = leerEntero(p + 8, 8);
+        return memcmp(p, FIRMA_INDICE, 4) == 0 &&
+               leerEntero(p + 4, 4) == VERSION &&
+               capacidadIndice >= CAPACIDAD_INICIAL && (capacidadIndice & (capacidadIndice - 1)) == 0 &&
+               largo == CABECERA_INDICE + capacidadIndice * TAMANO_RANURA &&
+               leerEntero(p + 24, 8) == largoRegistro;
+    }
+
+    /**
+     * Recorre el registro desde la cabecera llamando a 'alVisitar'
+     * (desplazamiento, largo, bajo, alto) por cada entrada completa, y
+     * devuelve dónde termina la última
+     */
+    template <typename Visitante>
+    uint64_t recorrerRegistro(Visitante alVisitar) {
+        char cabecera[CABECERA_ENTRADA];
+        uint64_t p = CABECERA_REGISTRO;
+        registro.clear();
+        while (p + CABECERA_ENTRADA <= largoRegistro) {
+            registro.seekg(p);
+            registro.read(cabecera, CABECERA_ENTRADA);
+            if (!registro) break;
+            int n = (uint8_t)cabecera[16];
+            bool resuelto = cabecera[17] != 0;
+
+            // Una entrada de un orden que no se guarda se salta sin indexarla
+            uint64_t largo = largoEntrada(n, resuelto);
+            if (p + largo > largoRegistro) break;
+            if (ordenAdmitido(n)) {
+                alVisitar(p, largo, leerEntero(cabecera, 8), leerEntero(cabecera + 8, 8));
+            }
+            p += largo;
+        }
+        registro.clear();
+        return p;
+    }
+
+    void reconstruirIndice() {
+        crearIndice(CAPACIDAD_INICIAL);
+        uint64_t fin = recorrerRegistro([&](uint64_t p, uint64_t, uint64_t bajo, uint64_t alto) {
+            insertarEnIndice(bajo, alto, p);
+        });
+
+        // Una entrada a medio escribir al final se descarta
+        if (fin < largoRegistro) {
+            registro.close();
+            truncarArchivo(ruta, fin);
+            abrirRegistro();
+        }
+        escribirEntero(indice->inicio() + 24, largoRegistro, 8);
+    }
+
+    /**
+     * Reemplaza 'destino' por 'origen' en un solo paso; si falla,
+     * 'destino' queda como estaba
+     */
+    static bool reemplazarArchivo(const string& origen, const string& destino) {
+#ifdef _WIN32
+        return MoveFileExA(origen.c_str(), destino.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+        return rename(origen.c_str(), destino.c_str()) == 0;
+#endif
+    }
+
+    static void truncarArchivo(const string& rutaArchivo, uint64_t bytes) {
+        ArchivoMapeadoEscritura archivo(rutaArchivo);
+        archivo.redimensionar(bytes);
+    }
+
+    void abrirRegistro() {
+        registro.open(ruta, ios::in | ios::out | ios::binary);
+        if (!registro.is_open()) {
+            // No existe: se crea con su cabecera
+            registro.clear();
+            registro.open(ruta, ios::in | ios::out | ios::binary | ios::trunc);
+            if (!registro.is_open()) {
+                throw runtime_error("No se pudo crear archivo: " + ruta);
+            }
+            string cabecera(FIRMA_REGISTRO, 4);
+            anadirEntero(cabecera, VERSION, 4);
+            registro.write(cabecera.data(), cabecera.size());
+            registro.flush();
+        }
+
+        registro.seekg(0, ios::end);
+        largoRegistro = (uint64_t)registro.tellg();
+        char cabecera[CABECERA_REGISTRO];
+        registro.seekg(0);
+        registro.read(cabecera, CABECERA_REGISTRO);
+        if (!registro || memcmp(cabecera, FIRMA_REGISTRO, 4) != 0) {
+            throw runtime_error("No es un archivo de cache de soluciones: " + ruta);
+        }
+        if (leerEntero(cabecera + 4, 4) != VERSION) {
+            throw runtime_error("Version de cache no soportada: " + ruta);
+        }
+    }
+
+    /**
+     * Reescribe el registro con las entradas más recientes que quepan en
+     * la mitad del máximo y reconstruye el índice
+     */
+    void compactar() {
+        vector<pair<uint64_t, uint64_t>> entradas;
+        recorrerRegistro([&](uint64_t p, uint64_t largo, uint64_t, uint64_t) {
+            entradas.push_back(make_pair(p, largo));
+        });
+
+        size_t primera = entradas.size();
+        uint64_t conservados = CABECERA_REGISTRO;
+        while (primera > 0 && conservados + entradas[primera - 1].second <= maximoBytes / 2) {
+            primera--;
+            conservados += entradas[primera].second;
+        }
+
+        string rutaTemporal = ruta + ".tmp";
+        {
+            ofstream nuevo(rutaTemporal, ios::binary | ios::trunc);
+            if (!nuevo.is_open()) {
+                throw runtime_error("No se pudo crear archivo: " + rutaTemporal);
+            }
+            string bufer(FIRMA_REGISTRO, 4);
+            anadirEntero(bufer, VERSION, 4);
+            for (size_t k = primera; k < entradas.size(); k++) {
+                size_t largo = bufer.size();
+                bufer.resize(largo + entradas[k].second);
+                registro.seekg(entradas[k].first);
+                registro.read(&bufer[largo], entradas[k].second);
+            }
+            nuevo.write(bufer.data(), bufer.size());
+            nuevo.close();
+            if (!nuevo) {
+                remove(rutaTemporal.c_str());
+                throw runtime_error("No se pudo escribir en: " + rutaTemporal);
+            }
+        }
+
+        // El registro viejo sigue intacto hasta que el nuevo lo reemplaza
+#ifdef _WIN32
+        registro.close();    // Windows no reemplaza un archivo abierto
+#endif
+        if (!reemplazarArchivo(rutaTemporal, ruta)) {
+            remove(rutaTemporal.c_str());
+            if (!registro.is_open()) abrirRegistro();
+            throw runtime_error("No se pudo reemplazar el archivo: " + ruta);
+        }
+        registro.close();
+        abrirRegistro();
+        reconstruirIndice();
+        compactaciones++;
+    }
+
+public:
+    /**
+     * Abre (o crea) la caché en 'rutaArchivo' y su índice en
+     * 'rutaArchivo'.idx
+     */
+    CachePersistente(const string& rutaArchivo, uint64_t maximo)
+        : ruta(rutaArchivo), maximoBytes(max<uint64_t>(maximo, 4096)) {
+        abrirRegistro();
+        indice.reset(new ArchivoMapeadoEscritura(ruta + ".idx"));
+        if (!indiceValido()) {
+            reconstruirIndice();
+        }
+    }
+
+    CachePersistente(const CachePersistente&) = delete;
+    CachePersistente& operator=(const CachePersistente&) = delete;
+
+    /**
+     * Busca el tablero; si está, 'resuelto' dice si tiene solución y la
+     * solución se copia en 'solucion'. Las entradas que no conservan las
+     * pistas o no son válidas (registro dañado) cuentan como fallo.
+     */
+    bool buscar(const int* celdas, int n, bool& resuelto, int* solucion) {
+        if (!ordenAdmitido(n)) return false;
+        uint64_t bajo, alto;
+        calcularHash(celdas, n, bajo, alto);
+
+        lock_guard<mutex> lock(mtx);
+        consultas++;
+        uint64_t desplazamiento = leerEntero(buscarRanura(bajo, alto) + 16, 8);
+        if (desplazamiento == 0) return false;
+
+        entrada.resize(largoEntrada(n, true));
+        registro.clear();
+        registro.seekg(desplazamiento);
+        registro.read(&entrada[0], CABECERA_ENTRADA);
+        if (!registro || (uint8_t)entrada[16] != n) return false;
+
+        resuelto = entrada[17] != 0;
+        if (resuelto) {
+            int total = n * n * n * n;
+            registro.read(&entrada[CABECERA_ENTRADA], bytesCeldas(n));
+            decodificadas.resize(total);
+            if (!registro || !desempaquetarCeldas((const uint8_t*)&entrada[CABECERA_ENTRADA], n, decodificadas.data())) {
+                return false;
+            }
+            for (int k = 0; k < total; k++) {
+                if (celdas[k] != 0 && celdas[k] != decodificadas[k]) return false;
+            }
+            if (validarTableroPlano(decodificadas.data(), n) != TABLERO_VALIDO) return false;
+            copy(decodificadas.begin(), decodificadas.end(), solucion);
+        }
+
+        aciertos++;
+        return true;
+    }
+
+    /**
+     * Añade el resultado de un tablero si no estaba ('solucion' se ignora
+     * si no está resuelto)
+     */
+    void guardar(const int* celdas, int n, bool resuelto, const int* solucion) {
+        if (!ordenAdmitido(n)) return;
+        uint64_t bajo, alto;
+        calcularHash(celdas, n, bajo, alto);
+
+        lock_guard<mutex> lock(mtx);
+        if (leerEntero(buscarRanura(bajo, alto) + 16, 8) != 0) return;
+
+        // Una entrada que no cabe en medio máximo no se guarda
+        uint64_t largo = largoEntrada(n, resuelto);
+        if (CABECERA_REGISTRO + largo > maximoBytes / 2) return;
+        if (largoRegistro + largo > maximoBytes) {
+            compactar();
+        }
+
+        entrada.clear();
+        anadirEntero(entrada, bajo, 8);
+        anadirEntero(entrada, alto, 8);
+        entrada.push_back((char)n);
+        entrada.push_back((char)(resuelto ? 1 : 0));
+        if (resuelto) {
+            empaquetarCeldas(solucion, n, entrada);
+        }
+
+        registro.clear();
+        registro.seekp(largoRegistro);
+        registro.write(entrada.data(), entrada.size());
+        registro.flush();
+        if (!registro) {
+            throw runtime_error("No se pudo escribir en: " + ruta);
+        }
+
+        insertarEnIndice(bajo, alto, largoRegistro);
+        largoRegistro += largo;
+        escribirEntero(indice->inicio() + 24, largoRegistro, 8);
+    }
+
+    size_t obtenerConsultas() const {
+        lock_guard<mutex> lock(mtx);
+        return consultas;
+    }
+
+    size_t obtenerAciertos() const {
+        lock_guard<mutex> lock(mtx);
+        return aciertos;
+    }
+
+    size_t obtenerCompactaciones() const {
+        lock_guard<mutex> lock(mtx);
+        return compactaciones;
+    }
+
+    size_t obtenerEntradas() const {
+        lock_guard<mutex> lock(mtx);
+        return (size_t)leerEntero(indice->inicio() + 16, 8);
+    }
+
+    uint64_t obtenerBytes() const {
+        lock_guard<mutex> lock(mtx);
+        return largoRegistro;
+    }
+};
+
+#endif
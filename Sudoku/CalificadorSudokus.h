@@ -0,0 +1,124 @@
+#ifndef CALIFICADOR_SUDOKUS_H
+#define CALIFICADOR_SUDOKUS_H
+
+#include "MotoresSudoku.h"
+
+using namespace std;
+
+/**
+ * Técnicas del propagador en orden de coste, como las aplica el motor
+ * híbrido
+ */
+enum TecnicaHumana {
+    TECNICA_NINGUNA = -1,   // el tablero ya estaba completo
+    TECNICA_SINGLES_DESNUDOS,
+    TECNICA_SINGLES_OCULTOS,
+    TECNICA_BLOQUEADOS,
+    TECNICA_SUBCONJUNTOS_DESNUDOS,
+    TECNICA_SUBCONJUNTOS_OCULTOS
+};
+
+enum NivelDificultad {
+    NIVEL_FACIL,        // singles
+    NIVEL_MEDIO,        // candidatos bloqueados
+    NIVEL_DIFICIL,      // pares y tríos desnudos
+    NIVEL_EXPERTO,      // pares y tríos ocultos
+    NIVEL_EXTREMO,      // las técnicas no bastan: hay que conjeturar
+    NIVEL_SIN_SOLUCION
+};
+
+struct Calificacion {
+    NivelDificultad nivel = NIVEL_SIN_SOLUCION;
+    TecnicaHumana tecnicaMaxima = TECNICA_NINGUNA;  // la más cara usada antes de conjeturar
+    ContadoresTecnicas usos;                        // usos de cada técnica antes de conjeturar
+    int conjeturas = 0;                             // decisiones en el camino a la solución
+    double puntuacionRamificacion = 0;              // log2 del árbol estimado (Knuth)
+    long long nodos = 0;
+};
+
+/**
+ * Califica sudokus por las técnicas humanas que hacen falta, no por los
+ * nodos de la búsqueda (que dependen del orden de la heurística).
+ *
+ * 1. Propagación sin ramificar con todas las técnicas, de la más barata
+ *    a la más cara y volviendo a empezar tras cada cambio: el nivel lo
+ *    marca la técnica más cara que llegó a usarse.
+ * 2. Si no basta, búsqueda con estadísticas: el nivel es extremo y la
+ *    puntuación de ramificación es la suma de log2(candidatos) de las
+ *    decisiones del camino a la solución.
+ *
+ * Un calificador no es seguro entre hilos: cada hilo usa el suyo.
+ */
+class CalificadorSudokus {
+private:
+    ResolvedorSudokuHibrido logico;
+    ResolvedorSudokuHibrido buscador;
+
+    static TecnicaHumana tecnicaMaxima(const ContadoresTecnicas& usos) {
+        if (usos.subconjuntosOcultos > 0) return TECNICA_SUBCONJUNTOS_OCULTOS;
+        if (usos.subconjuntosDesnudos > 0) return TECNICA_SUBCONJUNTOS_DESNUDOS;
+        if (usos.candidatosBloqueados > 0) return TECNICA_BLOQUEADOS;
+        if (usos.singlesOcultos > 0) return TECNICA_SINGLES_OCULTOS;
+        if (usos.singlesDesnudos > 0) return TECNICA_SINGLES_DESNUDOS;
+        return TECNICA_NINGUNA;
+    }
+
+public:
+    CalificadorSudokus() {
+        buscador.configurarEstadisticas(true);
+    }
+
+    Calificacion calificar(const int* celdas, int n) {
+        Calificacion calificacion;
+
+        logico.cargarSudoku(celdas, n);
+        bool resuelto = logico.propagarSinRamificar();
+        calificacion.usos = logico.obtenerContadores();
+        calificacion.tecnicaMaxima = tecnicaMaxima(calificacion.usos);
+        calificacion.nodos = logico.obtenerNodosExplorados();
+
+        if (resuelto) {
+            switch (calificacion.tecnicaMaxima) {
+                case TECNICA_SUBCONJUNTOS_OCULTOS: calificacion.nivel = NIVEL_EXPERTO; break;
+                case TECNICA_SUBCONJUNTOS_DESNUDOS: calificacion.nivel = NIVEL_DIFICIL; break;
+                case TECNICA_BLOQUEADOS: calificacion.nivel = NIVEL_MEDIO; break;
+                default: calificacion.nivel = NIVEL_FACIL; break;
+            }
+            return calificacion;
+        }
+
+        buscador.cargarSudoku(celdas, n);
+        if (buscador.resolverSudoku()) {
+            EstadisticasBusqueda estadisticas = buscador.obtenerEstadisticas();
+            calificacion.nivel = NIVEL_EXTREMO;
+            calificacion.conjeturas = estadisticas.decisionesCamino;
+            calificacion.puntuacionRamificacion = estadisticas.bitsCamino;
+        }
+        calificacion.nodos = buscador.obtenerNodosExplorados();
+        return calificacion;
+    }
+
+    static const char* nombreNivel(NivelDificultad nivel) {
+        switch (nivel) {
+            case NIVEL_FACIL: return "facil";
+            case NIVEL_MEDIO: return "medio";
+            case NIVEL_DIFICIL: return "dificil";
+            case NIVEL_EXPERTO: return "experto";
+            case NIVEL_EXTREMO: return "extremo";
+            default: return "sin solucion";
+        }
+    }
+
+    static const char* nombreTecnica(TecnicaHumana tecnica) {
+        switch (tecnica) {
+            case TECNICA_SINGLES_DESNUDOS: return "singles desnudos";
+            case TECNICA_SINGLES_OCULTOS: return "singles ocultos";
+            case TECNICA_BLOQUEADOS: return "candidatos bloqueados";
+            case TECNICA_SUBCONJUNTOS_DESNUDOS: return "subconjuntos desnudos";
+            case TECNICA_SUBCONJUNTOS_OCULTOS: return "subconjuntos ocultos";
+            default: return "ninguna";
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,209 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <chrono>
+
+#include "CalificadorSudokus.h"
+#include "LectorSudokus.h"
+#include "UtilidadesJson.h"
+
+using namespace std;
+
+/**
+ * Califica todos los sudokus de un archivo etiquetado. El archivo se
+ * recorre en streaming: los sudokus se agrupan en bloques que se
+ * califican en paralelo (un calificador por hilo) y se informan en orden.
+ */
+class CalificadorLote {
+private:
+    struct TareaCalificacion {
+        string etiqueta;
+        int n = 0;
+        vector<int> celdas;
+        Calificacion calificacion;
+    };
+
+    static const size_t TAMANO_BLOQUE = 4096;
+
+    int hilos = 1;
+    bool detalle = true;
+    ofstream json;
+    vector<unique_ptr<CalificadorSudokus>> calificadores;
+    long long porNivel[NIVEL_SIN_SOLUCION + 1] = {};
+    long long total = 0;
+
+    void escribirJson(const TareaCalificacion& tarea) {
+        const Calificacion& c = tarea.calificacion;
+        json << "{\"etiqueta\":\"" << escaparJson(tarea.etiqueta) << "\""
+             << ",\"n\":" << tarea.n
+             << ",\"nivel\":\"" << CalificadorSudokus::nombreNivel(c.nivel) << "\""
+             << ",\"tecnica_maxima\":\"" << CalificadorSudokus::nombreTecnica(c.tecnicaMaxima) << "\""
+             << ",\"tecnicas\":{\"singles_desnudos\":" << c.usos.singlesDesnudos
+             << ",\"singles_ocultos\":" << c.usos.singlesOcultos
+             << ",\"bloqueados\":" << c.usos.candidatosBloqueados
+             << ",\"subconjuntos_desnudos\":" << c.usos.subconjuntosDesnudos
+             << ",\"subconjuntos_ocultos\":" << c.usos.subconjuntosOcultos
+             << "},\"conjeturas\":" << c.conjeturas
+             << ",\"puntuacion_ramificacion\":" << c.puntuacionRamificacion
+             << ",\"nodos\":" << c.nodos << "}\n";
+    }
+
+    void procesarBloque(vector<TareaCalificacion>& bloque) {
+        atomic<size_t> siguiente(0);
+        auto trabajador = [&](int h) {
+            CalificadorSudokus& calificador = *calificadores[h];
+            for (size_t k = siguiente++; k < bloque.size(); k = siguiente++) {
+                bloque[k].calificacion = calificador.calificar(bloque[k].celdas.data(), bloque[k].n);
+            }
+        };
+
+        vector<thread> trabajadores;
+        for (int h = 1; h < hilos; h++) {
+            trabajadores.emplace_back(trabajador, h);
+        }
+        trabajador(0);
+        for (auto& t : trabajadores) {
+            t.join();
+        }
+
+        for (const auto& tarea : bloque) {
+            const Calificacion& c = tarea.calificacion;
+            total++;
+            porNivel[c.nivel]++;
+
+            if (detalle) {
+                cout << tarea.etiqueta << ": " << CalificadorSudokus::nombreNivel(c.nivel);
+                if (c.nivel == NIVEL_EXTREMO) {
+                    cout << " (" << c.conjeturas << " conjeturas, ramificacion "
+                         << fixed << setprecision(1) << c.puntuacionRamificacion << ")";
+                    cout.unsetf(ios::fixed);
+                } else if (c.nivel != NIVEL_SIN_SOLUCION) {
+                    cout << " (" << CalificadorSudokus::nombreTecnica(c.tecnicaMaxima) << ")";
+                }
+                cout << "\n";
+            }
+            if (json.is_open()) {
+                escribirJson(tarea);
+            }
+        }
+
+        bloque.clear();
+    }
+
+public:
+    void establecerHilos(int cantidad) {
+        hilos = max(1, cantidad);
+    }
+
+    /**
+     * false = solo el resumen, sin una línea por sudoku
+     */
+    void establecerDetalle(bool activo) {
+        detalle = activo;
+    }
+
+    /**
+     * Escribe una línea JSON por sudoku con su calificación completa
+     */
+    void establecerArchivoJson(const string& archivo) {
+        json.open(archivo);
+        if (!json.is_open()) {
+            throw runtime_error("No se pudo crear archivo: " + archivo);
+        }
+        json << setprecision(6);
+    }
+
+    void calificarArchivo(const string& archivo) {
+        calificadores.clear();
+        for (int h = 0; h < hilos; h++) {
+            calificadores.emplace_back(new CalificadorSudokus());
+        }
+
+        vector<TareaCalificacion> bloque;
+        bloque.reserve(TAMANO_BLOQUE);
+
+        LectorSudokus lector;
+        lector.leerArchivoPlano(archivo, [&](const TableroPlano& sudoku) {
+            if (sudoku.tamano == 0) return;
+            if (sudoku.tamano > 100) {
+                cerr << "Advertencia: " << sudoku.etiqueta << " excede tamaño maximo" << endl;
+                return;
+            }
+
+            TareaCalificacion tarea;
+            tarea.etiqueta = string(sudoku.etiqueta);
+            tarea.n = sudoku.n;
+            tarea.celdas.assign(sudoku.celdas, sudoku.celdas + (size_t)sudoku.tamano * sudoku.tamano);
+            bloque.push_back(move(tarea));
+            if (bloque.size() == TAMANO_BLOQUE) {
+                procesarBloque(bloque);
+            }
+        });
+        procesarBloque(bloque);
+
+        if (json.is_open()) {
+            json.close();
+        }
+    }
+
+    void imprimirResumen(double segundos) const {
+        cout << "\nTotal: " << total << endl;
+        for (int nivel = NIVEL_FACIL; nivel <= NIVEL_SIN_SOLUCION; nivel++) {
+            cout << CalificadorSudokus::nombreNivel((NivelDificultad)nivel) << ": " << porNivel[nivel] << endl;
+        }
+        cout << "Tiempo: " << fixed << setprecision(3) << segundos << " s ("
+             << setprecision(0) << (segundos > 0 ? total / segundos : 0.0) << " sudokus/s)" << endl;
+    }
+};
+
+/**
+ * Uso: calificar entrada [--hilos N] [--json archivo.jsonl] [--resumen]
+ */
+int main(int argc, char* argv[]) {
+    try {
+        string archivoEntrada = "sudokus_entrada.txt";
+        string archivoJson;
+        int hilos = 1;
+        bool soloResumen = false;
+
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if ((arg == "--hilos" || arg == "--threads") && i + 1 < argc) {
+                // 0 = un hilo por núcleo
+                hilos = stoi(argv[++i]);
+                if (hilos <= 0) hilos = max(1u, thread::hardware_concurrency());
+            } else if (arg == "--json" && i + 1 < argc) {
+                archivoJson = argv[++i];
+            } else if (arg == "--resumen") {
+                soloResumen = true;
+            } else {
+                archivoEntrada = arg;
+            }
+        }
+
+        CalificadorLote calificador;
+        calificador.establecerHilos(hilos);
+        calificador.establecerDetalle(!soloResumen);
+        if (!archivoJson.empty()) {
+            calificador.establecerArchivoJson(archivoJson);
+        }
+
+        cout << "Calificando " << archivoEntrada << "..." << endl;
+        auto inicio = chrono::steady_clock::now();
+        calificador.calificarArchivo(archivoEntrada);
+        auto fin = chrono::steady_clock::now();
+        calificador.imprimirResumen(chrono::duration<double>(fin - inicio).count());
+
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
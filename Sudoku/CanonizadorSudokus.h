@@ -0,0 +1,367 @@
+#ifndef CANONIZADOR_SUDOKUS_H
+#define CANONIZADOR_SUDOKUS_H
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <mutex>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+
+using namespace std;
+
+/**
+ * Transformación del grupo de simetrías del sudoku que lleva un tablero
+ * a su forma canónica: trasposición opcional, filas y columnas
+ * reordenadas (dentro de su banda o pila, y bandas y pilas enteras) y
+ * símbolos renombrados. Los tableros canónicos se guardan como cadenas
+ * de un byte por celda, por filas, 0 = vacía.
+ */
+struct TransformacionSudoku {
+    int n = 0;
+    bool traspuesta = false;
+    vector<int> filas;          // la fila canónica r es la fila filas[r] (tras trasponer)
+    vector<int> columnas;
+    vector<int> valores;        // valor original -> valor canónico (0 -> 0)
+    vector<int> originales;     // valor canónico -> valor original
+
+    // Celda del tablero original que ocupa la posición canónica (r, c)
+    int celdaOriginal(int r, int c) const {
+        int tamano = n * n;
+        int i = filas[r];
+        int j = columnas[c];
+        return traspuesta ? j * tamano + i : i * tamano + j;
+    }
+
+    /**
+     * Lleva un tablero del marco original (p. ej. la solución) al canónico
+     */
+    void aplicar(const int* original, string& canonico) const {
+        int tamano = n * n;
+        canonico.resize((size_t)tamano * tamano);
+        for (int r = 0; r < tamano; r++) {
+            for (int c = 0; c < tamano; c++) {
+                canonico[(size_t)r * tamano + c] = (char)valores[original[celdaOriginal(r, c)]];
+            }
+        }
+    }
+
+    /**
+     * Inversa de aplicar: devuelve un tablero canónico al marco original
+     */
+    void deshacer(const string& canonico, int* original) const {
+        int tamano = n * n;
+        for (int r = 0; r < tamano; r++) {
+            for (int c = 0; c < tamano; c++) {
+                original[celdaOriginal(r, c)] = originales[(unsigned char)canonico[(size_t)r * tamano + c]];
+            }
+        }
+    }
+};
+
+/**
+ * Calcula la forma canónica de un tablero: la menor, en orden
+ * lexicográfico por filas, entre las transformaciones que se prueban,
+ * con los símbolos renombrados en orden de aparición.
+ *
+ * Probar todo el grupo (3.359.232 transformaciones de posición en 9x9)
+ * es demasiado caro por sudoku. Las filas y columnas se ordenan antes
+ * por claves invariantes (pistas por línea, refinadas con las claves de
+ * las líneas que las cruzan y la frecuencia de cada símbolo) y solo se
+ * enumeran las permutaciones entre líneas empatadas. Si los empates dan
+ * más de MAX_CELDAS_COMPARADAS / celdas candidatos, el resto se desempata
+ * por posición: el resultado sigue siendo una transformación válida y
+ * solo se pierde la garantía de que dos tableros equivalentes coincidan.
+ *
+ * Un canonizador reutiliza sus búferes y no es seguro entre hilos.
+ */
+class CanonizadorSudokus {
+private:
+    static const int MAX_CELDAS_COMPARADAS = 1 << 20;
+    static const int RONDAS_REFINADO = 2;
+
+    int n = 0;
+    int tamano = 0;
+    vector<int> marco;                  // tablero traspuesto o no, por filas
+    vector<uint64_t> claveFila, claveCol, claveValor;
+    vector<uint64_t> nuevaFila, nuevaCol, nuevoValor;
+    vector<vector<uint64_t>> multiconjuntos;
+    vector<vector<int>> ordenesFilas, ordenesColumnas;
+    vector<int> mapa;
+    vector<int> mejorMapa;
+
+    static uint64_t mezclar(uint64_t a, uint64_t b) {
+        uint64_t z = a + 0x9E3779B97F4A7C15ULL * (b + 1);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Resumen de un multiconjunto de claves, independiente del orden
+    static uint64_t resumir(vector<uint64_t>& elementos) {
+        sort(elementos.begin(), elementos.end());
+        uint64_t resumen = elementos.size();
+        for (uint64_t e : elementos) {
+            resumen = mezclar(resumen, e);
+        }
+        return resumen;
+    }
+
+    /**
+     * Claves de filas, columnas y símbolos del marco que no cambian al
+     * permutar líneas ni renombrar símbolos
+     */
+    void calcularClaves() {
+        claveFila.assign(tamano, 0);
+        claveCol.assign(tamano, 0);
+        claveValor.assign(tamano + 1, 0);
+
+        for (int i = 0; i < tamano; i++) {
+            for (int j = 0; j < tamano; j++) {
+                int v = marco[i * tamano + j];
+                if (v == 0) continue;
+                claveFila[i]++;
+                claveCol[j]++;
+                claveValor[v]++;
+            }
+        }
+
+        // Multiconjuntos de cada fila, cada columna y cada símbolo (por las líneas en que aparece)
+        multiconjuntos.resize(3 * tamano + 1);
+        for (int ronda = 0; ronda < RONDAS_REFINADO; ronda++) {
+            for (auto& m : multiconjuntos) m.clear();
+
+            for (int i = 0; i < tamano; i++) {
+                for (int j = 0; j < tamano; j++) {
+                    int v = marco[i * tamano + j];
+                    if (v == 0) continue;
+                    multiconjuntos[i].push_back(mezclar(claveCol[j], claveValor[v]));
+                    multiconjuntos[tamano + j].push_back(mezclar(claveFila[i], claveValor[v]));
+                    multiconjuntos[2 * tamano + v].push_back(mezclar(claveFila[i], claveCol[j]));
+                }
+            }
+
+            nuevaFila.resize(tamano);
+            nuevaCol.resize(tamano);
+            nuevoValor.assign(tamano + 1, 0);
+            for (int k = 0; k < tamano; k++) {
+                nuevaFila[k] = mezclar(claveFila[k], resumir(multiconjuntos[k]));
+                nuevaCol[k] = mezclar(claveCol[k], resumir(multiconjuntos[tamano + k]));
+            }
+            for (int v = 1; v <= tamano; v++) {
+                nuevoValor[v] = mezclar(claveValor[v], resumir(multiconjuntos[2 * tamano + v]));
+            }
+
+            claveFila.swap(nuevaFila);
+            claveCol.swap(nuevaCol);
+            claveValor.swap(nuevoValor);
+        }
+    }
+
+    /**
+     * Órdenes de líneas compatibles con las claves, hasta 'maximo': las
+     * bandas se ordenan por el multiconjunto de claves de sus líneas y
+     * las líneas por su clave dentro de la banda. Las permutaciones de
+     * cada grupo empatado se recorren como un cuentakilómetros.
+     */
+    void enumerarOrdenes(const vector<uint64_t>& claves, size_t maximo, vector<vector<int>>& ordenes) {
+        vector<uint64_t> claveBanda(n);
+        vector<vector<int>> lineasBanda(n);
+        for (int b = 0; b < n; b++) {
+            vector<uint64_t> deBanda(claves.begin() + b * n, claves.begin() + (b + 1) * n);
+            claveBanda[b] = resumir(deBanda);
+
+            lineasBanda[b].resize(n);
+            iota(lineasBanda[b].begin(), lineasBanda[b].end(), b * n);
+            stable_sort(lineasBanda[b].begin(), lineasBanda[b].end(),
+                        [&](int x, int y) { return claves[x] < claves[y]; });
+        }
+
+        vector<int> bandas(n);
+        iota(bandas.begin(), bandas.end(), 0);
+        stable_sort(bandas.begin(), bandas.end(),
+                    [&](int x, int y) { return claveBanda[x] < claveBanda[y]; });
+
+        // Grupos empatados: [inicio, fin) dentro de 'bandas' o de una banda
+        struct Grupo {
+            vector<int>* lineas;
+            int inicio;
+            int fin;
+        };
+        vector<Grupo> grupos;
+        auto agregarEmpates = [&](vector<int>& lineas, const vector<uint64_t>& clave) {
+            for (int a = 0; a < n;) {
+                int b = a + 1;
+                while (b < n && clave[lineas[b]] == clave[lineas[a]]) b++;
+                if (b - a > 1) grupos.push_back({&lineas, a, b});
+                a = b;
+            }
+        };
+        agregarEmpates(bandas, claveBanda);
+        for (int b = 0; b < n; b++) {
+            agregarEmpates(lineasBanda[b], claves);
+        }
+
+        ordenes.clear();
+        while (ordenes.size() < maximo) {
+            ordenes.emplace_back();
+            for (int b : bandas) {
+                ordenes.back().insert(ordenes.back().end(), lineasBanda[b].begin(), lineasBanda[b].end());
+            }
+
+            size_t g = 0;
+            while (g < grupos.size() &&
+                   !next_permutation(grupos[g].lineas->begin() + grupos[g].inicio,
+                                     grupos[g].lineas->begin() + grupos[g].fin)) {
+                g++;
+            }
+            if (g == grupos.size()) break;
+        }
+    }
+
+    /**
+     * Compara el candidato (filas, columnas) con el mejor hasta ahora,
+     * renombrando símbolos en orden de aparición; si es menor lo deja en
+     * 'mejor'. Como el prefijo común ya está escrito, basta con escribir
+     * desde la primera celda menor y abandonar en la primera mayor.
+     */
+    bool probar(const vector<int>& filas, const vector<int>& columnas, bool hayMejor, string& mejor) {
+        mapa.assign(tamano + 1, 0);
+        int siguiente = 1;
+        bool mejorando = !hayMejor;
+
+        for (int r = 0; r < tamano; r++) {
+            const int* fila = &marco[filas[r] * tamano];
+            for (int c = 0; c < tamano; c++) {
+                int v = fila[columnas[c]];
+                int w = 0;
+                if (v != 0) {
+                    if (mapa[v] == 0) mapa[v] = siguiente++;
+                    w = mapa[v];
+                }
+
+                unsigned char actual = (unsigned char)mejor[r * tamano + c];
+                if (!mejorando) {
+                    if (w > actual) return false;
+                    if (w == actual) continue;
+                    mejorando = true;
+                }
+                mejor[r * tamano + c] = (char)w;
+            }
+        }
+        return mejorando;
+    }
+
+public:
+    /**
+     * Deja en 'clave' la forma canónica del tablero (tamano² bytes) y en
+     * 'transformacion' cómo se obtuvo. false si algún valor está fuera
+     * de [0, n²]: ese tablero no se canoniza.
+     */
+    bool canonizar(const int* celdas, int nParam, string& clave, TransformacionSudoku& transformacion) {
+        n = nParam;
+        tamano = n * n;
+        int totalCeldas = tamano * tamano;
+        for (int k = 0; k < totalCeldas; k++) {
+            if (celdas[k] < 0 || celdas[k] > tamano) return false;
+        }
+
+        size_t maximoCandidatos = max(2, MAX_CELDAS_COMPARADAS / totalCeldas) / 2;
+        clave.assign(totalCeldas, 0);
+        bool hayMejor = false;
+        marco.resize(totalCeldas);
+
+        for (int traspuesta = 0; traspuesta < 2; traspuesta++) {
+            for (int i = 0; i < tamano; i++) {
+                for (int j = 0; j < tamano; j++) {
+                    marco[i * tamano + j] = traspuesta ? celdas[j * tamano + i] : celdas[i * tamano + j];
+                }
+            }
+
+            calcularClaves();
+            enumerarOrdenes(claveFila, maximoCandidatos, ordenesFilas);
+            enumerarOrdenes(claveCol, max<size_t>(1, maximoCandidatos / ordenesFilas.size()), ordenesColumnas);
+
+            for (const auto& filas : ordenesFilas) {
+                for (const auto& columnas : ordenesColumnas) {
+                    if (probar(filas, columnas, hayMejor, clave)) {
+                        hayMejor = true;
+                        transformacion.traspuesta = traspuesta == 1;
+                        transformacion.filas = filas;
+                        transformacion.columnas = columnas;
+                        mejorMapa = mapa;
+                    }
+                }
+            }
+        }
+
+        // Los símbolos ausentes del tablero toman las etiquetas libres en orden
+        int siguiente = 1;
+        for (int v = 1; v <= tamano; v++) {
+            if (mejorMapa[v] != 0) siguiente++;
+        }
+        for (int v = 1; v <= tamano; v++) {
+            if (mejorMapa[v] == 0) mejorMapa[v] = siguiente++;
+        }
+
+        transformacion.n = n;
+        transformacion.valores = mejorMapa;
+        transformacion.originales.assign(tamano + 1, 0);
+        for (int v = 1; v <= tamano; v++) {
+            transformacion.originales[mejorMapa[v]] = v;
+        }
+        return true;
+    }
+};
+
+/**
+ * Caché en memoria de soluciones por forma canónica, compartida por los
+ * trabajadores del resolvedor. Guarda cada solución en el marco
+ * canónico (cadena vacía si el sudoku no tiene solución); al llegar a
+ * 'maximoEntradas' deja de admitir entradas nuevas.
+ */
+class CacheSoluciones {
+private:
+    mutable mutex mtx;
+    unordered_map<string, string> soluciones;
+    size_t maximoEntradas;
+    size_t consultas = 0;
+    size_t aciertos = 0;
+
+public:
+    explicit CacheSoluciones(size_t maximo = 1 << 18) : maximoEntradas(maximo) {}
+
+    bool buscar(const string& clave, string& solucion) {
+        lock_guard<mutex> lock(mtx);
+        consultas++;
+        auto it = soluciones.find(clave);
+        if (it == soluciones.end()) return false;
+        aciertos++;
+        solucion = it->second;
+        return true;
+    }
+
+    void guardar(const string& clave, const string& solucion) {
+        lock_guard<mutex> lock(mtx);
+        if (soluciones.size() >= maximoEntradas) return;
+        soluciones.emplace(clave, solucion);
+    }
+
+    size_t obtenerConsultas() const {
+        lock_guard<mutex> lock(mtx);
+        return consultas;
+    }
+
+    size_t obtenerAciertos() const {
+        lock_guard<mutex> lock(mtx);
+        return aciertos;
+    }
+
+    size_t obtenerEntradas() const {
+        lock_guard<mutex> lock(mtx);
+        return soluciones.size();
+    }
+};
+
+#endif
@@ -0,0 +1,340 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+
+#include "LectorSudokus.h"
+#include "EscritorSudokus.h"
+#include "FormatoBinario.h"
+#include "ProtocoloServidor.h"
+
+using namespace std;
+using namespace chrono;
+
+/**
+ * Peticiones ya codificadas; se envían en ciclo hasta completar la cantidad
+ */
+struct PeticionCodificada {
+    int n;
+    string bytes;
+};
+
+/**
+ * Resultado de una conexión del generador de carga
+ */
+struct MedicionConexion {
+    vector<double> latencias;   // microsegundos, una por respuesta
+    size_t porEstado[4] = { 0, 0, 0, 0 };
+};
+
+/**
+ * Generador de carga para el servidor: 'conexiones' conexiones en
+ * paralelo, cada una con hasta 'profundidad' peticiones sin responder.
+ * La latencia de cada petición va desde que se entrega al socket hasta
+ * que se recibe su respuesta completa.
+ */
+class GeneradorCarga {
+private:
+    string ruta = RUTA_SOCKET_POR_DEFECTO;
+    bool binaria = false;
+    int conexiones = 1;
+    size_t profundidad = 32;
+    size_t cantidad = 0;
+
+    vector<PeticionCodificada> peticiones;
+    atomic<size_t> siguiente{0};
+
+    /**
+     * Estado de una respuesta de texto: la línea tras la etiqueta
+     */
+    static int estadoTexto(const char* bloque, size_t largo) {
+        const char* salto = (const char*)memchr(bloque, '\n', largo);
+        if (!salto) return RESPUESTA_INVALIDA;
+        string_view linea(salto + 1, bloque + largo - salto - 1);
+        if (linea.compare(0, strlen(textoMotivo(MOTIVO_SIN_SOLUCION)), textoMotivo(MOTIVO_SIN_SOLUCION)) == 0) {
+            return RESPUESTA_SIN_SOLUCION;
+        }
+        if (linea.compare(0, strlen(textoMotivo(MOTIVO_TIEMPO_AGOTADO)), textoMotivo(MOTIVO_TIEMPO_AGOTADO)) == 0) {
+            return RESPUESTA_TIEMPO_AGOTADO;
+        }
+        if (linea.compare(0, strlen(textoMotivo(MOTIVO_DIMENSIONES_INVALIDAS)),
+                          textoMotivo(MOTIVO_DIMENSIONES_INVALIDAS)) == 0) {
+            return RESPUESTA_INVALIDA;
+        }
+        return RESPUESTA_RESUELTO;
+    }
+
+    void ejecutarConexion(MedicionConexion& medicion) {
+        int fd = conectarSocket(ruta);
+        if (binaria && !enviarTodo(fd, FIRMA_BINARIA, sizeof(FIRMA_BINARIA))) {
+            close(fd);
+            throw runtime_error("El servidor cerro la conexion");
+        }
+
+        // Envíos pendientes de respuesta: instante y petición
+        mutex mtx;
+        condition_variable hayHueco;
+        deque<pair<steady_clock::time_point, size_t>> enVuelo;
+        bool envioTerminado = false;
+
+        thread envio([&]() {
+            string bufer;
+            vector<size_t> lote;
+            bool quedan = true;
+            while (quedan) {
+                size_t libres;
+                {
+                    unique_lock<mutex> lock(mtx);
+                    hayHueco.wait(lock, [&] { return enVuelo.size() < profundidad; });
+                    libres = profundidad - enVuelo.size();
+                }
+
+                // Se llena la ventana libre con un solo envío
+                bufer.clear();
+                lote.clear();
+                while (lote.size() < libres) {
+                    size_t k = siguiente++;
+                    if (k >= cantidad) {
+                        quedan = false;
+                        break;
+                    }
+                    size_t indice = k % peticiones.size();
+                    lote.push_back(indice);
+                    bufer += peticiones[indice].bytes;
+                }
+                if (lote.empty()) break;
+
+                {
+                    lock_guard<mutex> lock(mtx);
+                    auto ahora = steady_clock::now();
+                    for (size_t indice : lote) {
+                        enVuelo.emplace_back(ahora, indice);
+                    }
+                }
+                if (!enviarTodo(fd, bufer.data(), bufer.size())) break;
+            }
+            // El servidor responde lo pendiente y cierra: así termina la lectura
+            shutdown(fd, SHUT_WR);
+            lock_guard<mutex> lock(mtx);
+            envioTerminado = true;
+        });
+
+        string bufer;
+        vector<char> trozo(1 << 16);
+        while (true) {
+            {
+                lock_guard<mutex> lock(mtx);
+                if (envioTerminado && enVuelo.empty()) break;
+            }
+            ssize_t leidos = recv(fd, trozo.data(), trozo.size(), 0);
+            if (leidos < 0 && errno == EINTR) continue;
+            if (leidos <= 0) break;
+            bufer.append(trozo.data(), (size_t)leidos);
+
+            // Separar las respuestas completas
+            size_t consumidos = 0;
+            while (true) {
+                size_t largo;
+                int estado;
+                {
+                    lock_guard<mutex> lock(mtx);
+                    if (enVuelo.empty()) break;
+                }
+                if (binaria) {
+                    if (consumidos >= bufer.size()) break;
+                    estado = (uint8_t)bufer[consumidos];
+                    size_t indice;
+                    {
+                        lock_guard<mutex> lock(mtx);
+                        indice = enVuelo.front().second;
+                    }
+                    largo = largoRespuestaBinaria(estado, peticiones[indice].n);
+                    if (bufer.size() - consumidos < largo) break;
+                } else {
+                    size_t fin = bufer.find("\n\n", consumidos);
+                    if (fin == string::npos) break;
+                    largo = fin + 2 - consumidos;
+                    estado = estadoTexto(bufer.data() + consumidos, largo);
+                }
+
+                auto ahora = steady_clock::now();
+                {
+                    lock_guard<mutex> lock(mtx);
+                    medicion.latencias.push_back(duration<double, micro>(ahora - enVuelo.front().first).count());
+                    enVuelo.pop_front();
+                }
+                hayHueco.notify_one();
+                medicion.porEstado[min(estado, 3)]++;
+                consumidos += largo;
+            }
+            bufer.erase(0, consumidos);
+        }
+
+        // Si el servidor cerró antes de tiempo el envío no debe quedar esperando
+        shutdown(fd, SHUT_RDWR);
+        {
+            lock_guard<mutex> lock(mtx);
+            enVuelo.clear();
+        }
+        hayHueco.notify_all();
+        envio.join();
+        close(fd);
+    }
+
+    static double percentil(const vector<double>& ordenadas, double p) {
+        if (ordenadas.empty()) return 0;
+        size_t k = (size_t)(p / 100.0 * (ordenadas.size() - 1) + 0.5);
+        return ordenadas[min(k, ordenadas.size() - 1)];
+    }
+
+public:
+    /**
+     * Codifica los sudokus del archivo en el formato de petición elegido
+     */
+    size_t cargarPeticiones(const string& archivo) {
+        LectorSudokus lector;
+        FormateadorTexto formateador;
+        lector.leerArchivoPlano(archivo, [&](const TableroPlano& sudoku) {
+            if (sudoku.tamano == 0) return;
+            PeticionCodificada peticion;
+            peticion.n = sudoku.n;
+            if (binaria) {
+                anadirPeticionBinaria(peticion.bytes, sudoku.celdas, sudoku.n);
+            } else {
+                peticion.bytes.assign(sudoku.etiqueta.data(), sudoku.etiqueta.size());
+                peticion.bytes.push_back('\n');
+                formateador.anadirFilas(peticion.bytes, sudoku.celdas, sudoku.n);
+                peticion.bytes.push_back('\n');
+            }
+            peticiones.push_back(move(peticion));
+        });
+        return peticiones.size();
+    }
+
+    void ejecutar() {
+        if (peticiones.empty()) {
+            throw runtime_error("No se encontraron sudokus");
+        }
+        if (cantidad == 0) cantidad = peticiones.size();
+
+        vector<MedicionConexion> mediciones(conexiones);
+        vector<exception_ptr> errores(conexiones);
+        auto inicio = steady_clock::now();
+        vector<thread> hilos;
+        for (int c = 0; c < conexiones; c++) {
+            hilos.emplace_back([&, c]() {
+                try {
+                    ejecutarConexion(mediciones[c]);
+                } catch (...) {
+                    errores[c] = current_exception();
+                }
+            });
+        }
+        for (auto& t : hilos) {
+            t.join();
+        }
+        double segundos = duration<double>(steady_clock::now() - inicio).count();
+
+        for (auto& e : errores) {
+            if (e) rethrow_exception(e);
+        }
+
+        vector<double> latencias;
+        size_t porEstado[4] = { 0, 0, 0, 0 };
+        for (const auto& m : mediciones) {
+            latencias.insert(latencias.end(), m.latencias.begin(), m.latencias.end());
+            for (int k = 0; k < 4; k++) porEstado[k] += m.porEstado[k];
+        }
+        sort(latencias.begin(), latencias.end());
+
+        cout << "Respuestas: " << latencias.size() << " de " << cantidad << " en "
+             << fixed << setprecision(3) << segundos << " s ("
+             << setprecision(0) << (segundos > 0 ? latencias.size() / segundos : 0.0) << " sudokus/s)" << endl;
+        cout << "Latencia (us): p50 " << setprecision(1) << percentil(latencias, 50)
+             << ", p90 " << percentil(latencias, 90)
+             << ", p99 " << percentil(latencias, 99)
+             << ", p99.9 " << percentil(latencias, 99.9)
+             << ", max " << (latencias.empty() ? 0.0 : latencias.back()) << endl;
+        cout.unsetf(ios::fixed);
+        cout << "Resueltos: " << porEstado[RESPUESTA_RESUELTO]
+             << ", sin solucion: " << porEstado[RESPUESTA_SIN_SOLUCION]
+             << ", tiempo agotado: " << porEstado[RESPUESTA_TIEMPO_AGOTADO]
+             << ", invalidos: " << porEstado[RESPUESTA_INVALIDA] << endl;
+    }
+
+    void establecerRuta(const string& nueva) {
+        ruta = nueva;
+    }
+
+    void establecerBinaria(bool activa) {
+        binaria = activa;
+    }
+
+    void establecerConexiones(int cantidadConexiones) {
+        conexiones = max(1, cantidadConexiones);
+    }
+
+    void establecerProfundidad(size_t peticionesEnVuelo) {
+        profundidad = max<size_t>(1, peticionesEnVuelo);
+    }
+
+    /**
+     * Peticiones en total (0 = una por sudoku del archivo)
+     */
+    void establecerCantidad(size_t total) {
+        cantidad = total;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    try {
+        string archivoEntrada = "sudokus_entrada.txt";
+        GeneradorCarga generador;
+        string formato = "texto";
+
+        // Uso: cliente-carga [entrada] [--socket ruta] [--formato texto|binario]
+        //                    [--conexiones N] [--profundidad N] [--cantidad N]
+        vector<string> posicionales;
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--socket" && i + 1 < argc) {
+                generador.establecerRuta(argv[++i]);
+            } else if (arg == "--formato" && i + 1 < argc) {
+                formato = argv[++i];
+                if (formato != "texto" && formato != "binario") {
+                    throw runtime_error("Formato desconocido: " + formato);
+                }
+            } else if (arg == "--conexiones" && i + 1 < argc) {
+                generador.establecerConexiones(stoi(argv[++i]));
+            } else if (arg == "--profundidad" && i + 1 < argc) {
+                generador.establecerProfundidad(stoul(argv[++i]));
+            } else if (arg == "--cantidad" && i + 1 < argc) {
+                generador.establecerCantidad(stoul(argv[++i]));
+            } else {
+                posicionales.push_back(arg);
+            }
+        }
+        if (posicionales.size() > 0) archivoEntrada = posicionales[0];
+        generador.establecerBinaria(formato == "binario");
+
+        cout << "=== GENERADOR DE CARGA N-SUDOKU ===" << endl << endl;
+        cout << "Leyendo: " << archivoEntrada << endl;
+        size_t cargados = generador.cargarPeticiones(archivoEntrada);
+        cout << "Sudokus distintos: " << cargados << " (formato " << formato << ")" << endl << endl;
+
+        generador.ejecutar();
+
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
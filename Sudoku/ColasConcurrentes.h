@@ -0,0 +1,147 @@
+#ifndef COLAS_CONCURRENTES_H
+#define COLAS_CONCURRENTES_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Cola FIFO de capacidad fija entre dos etapas de procesamiento. 'poner'
+ * bloquea mientras está llena (contrapresión sobre el productor) y
+ * 'sacar' devuelve false cuando se cerró y ya no quedan elementos.
+ */
+template<typename T>
+class ColaAcotada {
+private:
+    deque<T> elementos;
+    size_t capacidad;
+    bool cerrada = false;
+    mutex mtx;
+    condition_variable hayEspacio;
+    condition_variable hayElementos;
+    
+public:
+    explicit ColaAcotada(size_t capacidadMaxima) : capacidad(max<size_t>(1, capacidadMaxima)) {}
+    
+    void poner(T elemento) {
+        unique_lock<mutex> lock(mtx);
+        hayEspacio.wait(lock, [&] { return elementos.size() < capacidad || cerrada; });
+        if (cerrada) return;
+        elementos.push_back(move(elemento));
+        hayElementos.notify_one();
+    }
+    
+    bool sacar(T& elemento) {
+        unique_lock<mutex> lock(mtx);
+        hayElementos.wait(lock, [&] { return !elementos.empty() || cerrada; });
+        if (elementos.empty()) return false;
+        elemento = move(elementos.front());
+        elementos.pop_front();
+        hayEspacio.notify_one();
+        return true;
+    }
+    
+    /**
+     * Versiones sin espera: devuelven false si la cola está llena o vacía
+     */
+    bool intentarPoner(T& elemento) {
+        lock_guard<mutex> lock(mtx);
+        if (elementos.size() >= capacidad || cerrada) return false;
+        elementos.push_back(move(elemento));
+        hayElementos.notify_one();
+        return true;
+    }
+    
+    bool intentarSacar(T& elemento) {
+        lock_guard<mutex> lock(mtx);
+        if (elementos.empty()) return false;
+        elemento = move(elementos.front());
+        elementos.pop_front();
+        hayEspacio.notify_one();
+        return true;
+    }
+    
+    void cerrar() {
+        lock_guard<mutex> lock(mtx);
+        cerrada = true;
+        hayEspacio.notify_all();
+        hayElementos.notify_all();
+    }
+};
+
+/**
+ * Reordena los resultados que llegan fuera de orden desde los
+ * trabajadores. Solo admite índices dentro de una ventana a partir del
+ * siguiente a escribir, así que un sudoku lento no hace crecer la
+ * memoria: los trabajadores que se adelantan esperan.
+ */
+template<typename T>
+class VentanaOrdenada {
+private:
+    deque<T> elementos;
+    deque<char> presentes;
+    size_t siguiente = 0;
+    size_t ventana;
+    bool cerrada = false;
+    mutex mtx;
+    condition_variable hayEspacio;
+    condition_variable haySiguiente;
+    
+    void extraerSiguiente(T& elemento) {
+        elemento = move(elementos.front());
+        elementos.pop_front();
+        presentes.pop_front();
+        elementos.emplace_back();
+        presentes.push_back(0);
+        siguiente++;
+        hayEspacio.notify_all();
+    }
+    
+public:
+    explicit VentanaOrdenada(size_t tamanoVentana)
+        : elementos(max<size_t>(1, tamanoVentana)), presentes(max<size_t>(1, tamanoVentana), 0),
+          ventana(max<size_t>(1, tamanoVentana)) {}
+    
+    void poner(size_t indice, T elemento) {
+        unique_lock<mutex> lock(mtx);
+        // El dueño de 'siguiente' nunca espera, así que no hay bloqueo mutuo
+        hayEspacio.wait(lock, [&] { return indice < siguiente + ventana || cerrada; });
+        if (cerrada) return;
+        elementos[indice - siguiente] = move(elemento);
+        presentes[indice - siguiente] = 1;
+        if (indice == siguiente) haySiguiente.notify_one();
+    }
+    
+    /**
+     * Entrega el siguiente elemento en orden; false si se cerró y no llegará
+     */
+    bool sacar(T& elemento) {
+        unique_lock<mutex> lock(mtx);
+        haySiguiente.wait(lock, [&] { return presentes.front() || cerrada; });
+        if (!presentes.front()) return false;
+        extraerSiguiente(elemento);
+        return true;
+    }
+    
+    /**
+     * Versión sin espera: false si el siguiente todavía no llegó
+     */
+    bool intentarSacar(T& elemento) {
+        lock_guard<mutex> lock(mtx);
+        if (!presentes.front()) return false;
+        extraerSiguiente(elemento);
+        return true;
+    }
+    
+    void cerrar() {
+        lock_guard<mutex> lock(mtx);
+        cerrada = true;
+        hayEspacio.notify_all();
+        haySiguiente.notify_all();
+    }
+};
+
+#endif
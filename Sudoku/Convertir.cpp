@@ -0,0 +1,93 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+
+#include "LectorSudokus.h"
+#include "EscritorSudokus.h"
+#include "FormatoBinario.h"
+
+using namespace std;
+
+/**
+ * Conversor entre el formato de texto etiquetado y el formato binario
+ * compacto (.sdkb). La dirección se deduce del archivo de entrada: un
+ * archivo binario se pasa a texto y cualquier otro a binario.
+ */
+class ConversorSudokus {
+public:
+    /**
+     * Convierte 'entrada' en 'salida' y devuelve la cantidad de registros
+     */
+    size_t convertir(const string& entrada, const string& salida, bool aBinario) {
+        unique_ptr<EscritorSudokus> escritor;
+        if (aBinario) {
+            escritor.reset(new EscritorBinario(salida));
+        } else {
+            escritor.reset(new EscritorTexto(salida));
+        }
+
+        LectorSudokus lector;
+        size_t registros = 0;
+        lector.leerArchivoPlano(entrada, [&](const TableroPlano& sudoku) {
+            if (sudoku.tamano == 0) {
+                escritor->escribirSinTablero(sudoku.etiqueta, sudoku.motivo);
+            } else {
+                escritor->escribir(sudoku.etiqueta, sudoku.celdas, sudoku.n);
+            }
+            registros++;
+        });
+        escritor->cerrar();
+
+        return registros;
+    }
+
+    static bool esBinario(const string& archivo) {
+        ifstream file(archivo, ios::binary);
+        if (!file.is_open()) {
+            throw runtime_error("No se pudo abrir el archivo: " + archivo);
+        }
+        char firma[sizeof(FIRMA_BINARIA)] = {};
+        file.read(firma, sizeof(firma));
+        return esFormatoBinario(firma, (size_t)file.gcount());
+    }
+};
+
+/**
+ * Uso: convertir entrada salida
+ */
+int main(int argc, char* argv[]) {
+    try {
+        if (argc < 3) {
+            cerr << "Uso: " << argv[0] << " entrada salida" << endl;
+            return 1;
+        }
+
+        string entrada = argv[1];
+        string salida = argv[2];
+        bool aBinario = !ConversorSudokus::esBinario(entrada);
+
+        cout << "Convirtiendo " << entrada << " a " << (aBinario ? "binario" : "texto") << "..." << endl;
+
+        auto inicio = chrono::high_resolution_clock::now();
+        ConversorSudokus conversor;
+        size_t registros = conversor.convertir(entrada, salida, aBinario);
+        auto fin = chrono::high_resolution_clock::now();
+
+        ifstream tamanoEntrada(entrada, ios::binary | ios::ate);
+        ifstream tamanoSalida(salida, ios::binary | ios::ate);
+        cout << "Registros: " << registros << endl;
+        cout << "Tamano: " << tamanoEntrada.tellg() << " -> " << tamanoSalida.tellg() << " bytes" << endl;
+        cout << "Tiempo: " << fixed << setprecision(3)
+             << chrono::duration<double>(fin - inicio).count() << " s" << endl;
+
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+#ifndef ESCRITOR_SUDOKUS_H
+#define ESCRITOR_SUDOKUS_H
+
+#include <fstream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+
+using namespace std;
+
+/**
+ * Motivo de un bloque sin tablero
+ */
+enum MotivoSinTablero {
+    MOTIVO_SIN_SOLUCION = 0,
+    MOTIVO_TIEMPO_AGOTADO = 1,
+    MOTIVO_DIMENSIONES_INVALIDAS = 2    // solo lo entrega el lector si se le pide
+};
+
+inline const char* textoMotivo(int motivo) {
+    if (motivo == MOTIVO_TIEMPO_AGOTADO) return "Tiempo agotado";
+    if (motivo == MOTIVO_DIMENSIONES_INVALIDAS) return "Dimensiones invalidas";
+    return "Sin solucion";
+}
+
+/**
+ * Interfaz común de los escritores de archivos de sudokus etiquetados.
+ * Los tableros llegan planos, por filas, con 0 para las celdas vacías.
+ */
+class EscritorSudokus {
+public:
+    virtual ~EscritorSudokus() {}
+    virtual void escribir(string_view etiqueta, const int* celdas, int n) = 0;
+
+    // Bloque sin tablero ("Sin solucion" o "Tiempo agotado")
+    virtual void escribirSinTablero(string_view etiqueta, int motivo = MOTIVO_SIN_SOLUCION) = 0;
+    virtual void cerrar() = 0;
+};
+
+/**
+ * Formatea las filas de un tablero en el formato de texto con una tabla
+ * de símbolos ya rellenados con ceros, que se conserva mientras no
+ * cambie el tamaño
+ */
+class FormateadorTexto {
+private:
+    // Símbolos de 'anchoTabla' caracteres para los valores 0..tamanoTabla
+    vector<char> tablaSimbolos;
+    int tamanoTabla = -1;
+    int anchoTabla = 0;
+
+    void prepararTabla(int tamano) {
+        if (tamano == tamanoTabla) return;
+
+        int ancho = 1;
+        for (int limite = 10; tamano >= limite; limite *= 10) ancho++;
+
+        tablaSimbolos.assign((size_t)(tamano + 1) * ancho, '-');
+        for (int valor = 1; valor <= tamano; valor++) {
+            char* simbolo = &tablaSimbolos[(size_t)valor * ancho];
+            for (int k = ancho - 1, resto = valor; k >= 0; k--, resto /= 10) {
+                simbolo[k] = (char)('0' + resto % 10);
+            }
+        }
+
+        tamanoTabla = tamano;
+        anchoTabla = ancho;
+    }
+
+public:
+    /**
+     * Añade a 'destino' las filas del tablero, cada una terminada en '\n'
+     */
+    void anadirFilas(string& destino, const int* celdas, int n) {
+        int tamano = n * n;
+        prepararTabla(tamano);
+
+        size_t inicio = destino.size();
+        destino.resize(inicio + (size_t)tamano * (tamano * anchoTabla + 1));
+        char* p = &destino[inicio];
+
+        for (int i = 0; i < tamano; i++) {
+            for (int j = 0; j < tamano; j++) {
+                int valor = celdas[i * tamano + j];
+                // Los valores fuera de rango se escriben como celdas vacías
+                if (valor < 0 || valor > tamano) valor = 0;
+                const char* simbolo = &tablaSimbolos[(size_t)valor * anchoTabla];
+                for (int k = 0; k < anchoTabla; k++) {
+                    *p++ = simbolo[k];
+                }
+            }
+            *p++ = '\n';
+        }
+    }
+};
+
+/**
+ * Escritor del formato de texto. Formatea en un búfer reutilizado y
+ * vuelca al archivo en bloques grandes, sin vaciar el flujo en cada fila.
+ */
+class EscritorTexto : public EscritorSudokus {
+private:
+    static const size_t TAMANO_VOLCADO = 1 << 20;
+
+    ofstream archivo;
+    string bufer;
+    bool primero = true;
+    FormateadorTexto formateador;
+
+    void empezarBloque(string_view etiqueta) {
+        if (!primero) {
+            bufer.push_back('\n');
+        }
+        primero = false;
+
+        bufer.append(etiqueta.data(), etiqueta.size());
+        bufer.push_back('\n');
+    }
+
+    void volcarSiLleno() {
+        if (bufer.size() >= TAMANO_VOLCADO) {
+            archivo.write(bufer.data(), bufer.size());
+            bufer.clear();
+        }
+    }
+
+public:
+    explicit EscritorTexto(const string& ruta) : archivo(ruta) {
+        if (!archivo.is_open()) {
+            throw runtime_error("No se pudo crear archivo: " + ruta);
+        }
+        bufer.reserve(TAMANO_VOLCADO + (1 << 16));
+    }
+
+    ~EscritorTexto() override {
+        if (archivo.is_open()) {
+            try { cerrar(); } catch (...) {}
+        }
+    }
+
+    void escribir(string_view etiqueta, const int* celdas, int n) override {
+        empezarBloque(etiqueta);
+        formateador.anadirFilas(bufer, celdas, n);
+        volcarSiLleno();
+    }
+
+    void escribirSinTablero(string_view etiqueta, int motivo = MOTIVO_SIN_SOLUCION) override {
+        empezarBloque(etiqueta);
+        bufer += textoMotivo(motivo);
+        bufer.push_back('\n');
+        volcarSiLleno();
+    }
+
+    void cerrar() override {
+        archivo.write(bufer.data(), bufer.size());
+        bufer.clear();
+        archivo.close();
+    }
+};
+
+#endif
@@ -0,0 +1,306 @@
+#ifndef FORMATO_BINARIO_H
+#define FORMATO_BINARIO_H
+
+#include <fstream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+
+#include "EscritorSudokus.h"
+
+using namespace std;
+
+/**
+ * Formato binario compacto para archivos de sudokus (extensión .sdkb).
+ * Todos los enteros son little-endian.
+ *
+ *   Cabecera (24 bytes):
+ *     "SDKB"              firma
+ *     uint32 version      VERSION_FORMATO_BINARIO
+ *     uint64 cantidad     número de registros
+ *     uint64 indice       desplazamiento de la tabla de índices (0 si el
+ *                         archivo quedó sin cerrar; se reconstruye leyendo)
+ *   Registros, uno tras otro:
+ *     uint8  n            orden del subcuadrado; 0 = bloque sin tablero
+ *     uint8  motivo       solo si n = 0: MotivoSinTablero
+ *     uint16 largo        bytes de la etiqueta
+ *     etiqueta
+ *     celdas empaquetadas por filas con el mínimo de bits que admite
+ *     tamano (4 bits en 9x9, 5 en 16x16 y 25x25, 6 en 36x36 y 7 hasta
+ *     100x100), 0 = vacía, rellenadas
+ *     hasta el siguiente byte
+ *   Índice: 'cantidad' uint64 con el desplazamiento de cada registro
+ */
+static const char FIRMA_BINARIA[4] = { 'S', 'D', 'K', 'B' };
+static const uint32_t VERSION_FORMATO_BINARIO = 1;
+static const size_t TAMANO_CABECERA_BINARIA = 24;
+
+inline int bitsPorCelda(int tamano) {
+    int bits = 0;
+    while ((1 << bits) <= tamano) bits++;
+    return bits;
+}
+
+inline size_t bytesCeldas(int n) {
+    size_t tamano = (size_t)n * n;
+    return (tamano * tamano * bitsPorCelda((int)tamano) + 7) / 8;
+}
+
+inline bool esFormatoBinario(const char* datos, size_t largo) {
+    return largo >= sizeof(FIRMA_BINARIA) && memcmp(datos, FIRMA_BINARIA, sizeof(FIRMA_BINARIA)) == 0;
+}
+
+inline uint64_t leerEntero(const char* p, int bytes) {
+    uint64_t valor = 0;
+    for (int i = bytes - 1; i >= 0; i--) {
+        valor = (valor << 8) | (uint8_t)p[i];
+    }
+    return valor;
+}
+
+/**
+ * Añade a 'destino' las celdas de un tablero de orden n empaquetadas con
+ * bitsPorCelda bits cada una (bytesCeldas(n) bytes)
+ */
+inline void empaquetarCeldas(const int* celdas, int n, string& destino) {
+    int tamano = n * n;
+    int bits = bitsPorCelda(tamano);
+    uint64_t acumulado = 0;
+    int bitsAcumulados = 0;
+    for (int k = 0; k < tamano * tamano; k++) {
+        uint64_t valor = (celdas[k] >= 0 && celdas[k] <= tamano) ? celdas[k] : 0;
+        acumulado |= valor << bitsAcumulados;
+        bitsAcumulados += bits;
+        while (bitsAcumulados >= 8) {
+            destino.push_back((char)acumulado);
+            acumulado >>= 8;
+            bitsAcumulados -= 8;
+        }
+    }
+    if (bitsAcumulados > 0) {
+        destino.push_back((char)acumulado);
+    }
+}
+
+/**
+ * Inversa de empaquetarCeldas. Devuelve false si algún valor excede n²
+ * (solo pasa si los datos están dañados).
+ */
+inline bool desempaquetarCeldas(const uint8_t* empaquetado, int n, int* celdas) {
+    int tamano = n * n;
+    int total = tamano * tamano;
+    int bits = bitsPorCelda(tamano);
+
+    if (bits == 4) {
+        for (int k = 0; k + 1 < total; k += 2) {
+            uint8_t par = empaquetado[k >> 1];
+            celdas[k] = par & 0xF;
+            celdas[k + 1] = par >> 4;
+        }
+        if (total & 1) celdas[total - 1] = empaquetado[total >> 1] & 0xF;
+    } else {
+        uint64_t acumulado = 0;
+        int bitsAcumulados = 0;
+        uint32_t mascara = (1u << bits) - 1;
+        for (int k = 0; k < total; k++) {
+            while (bitsAcumulados < bits) {
+                acumulado |= (uint64_t)(*empaquetado++) << bitsAcumulados;
+                bitsAcumulados += 8;
+            }
+            celdas[k] = (int)(acumulado & mascara);
+            acumulado >>= bits;
+            bitsAcumulados -= bits;
+        }
+    }
+
+    for (int k = 0; k < total; k++) {
+        if (celdas[k] > tamano) return false;
+    }
+    return true;
+}
+
+/**
+ * Escribe registros en formato binario a medida que llegan; 'cerrar'
+ * añade el índice y completa la cabecera
+ */
+class EscritorBinario : public EscritorSudokus {
+private:
+    ofstream archivo;
+    vector<uint64_t> desplazamientos;
+    uint64_t posicion = 0;
+    string bufer;
+
+    void anadirEntero(uint64_t valor, int bytes) {
+        for (int i = 0; i < bytes; i++) {
+            bufer.push_back((char)(valor >> (8 * i)));
+        }
+    }
+
+    void volcarBufer() {
+        archivo.write(bufer.data(), bufer.size());
+        posicion += bufer.size();
+        bufer.clear();
+    }
+
+    void anadirCabeceraRegistro(string_view etiqueta, int n, int motivo = 0) {
+        if (etiqueta.size() > 0xFFFF) {
+            throw runtime_error("Etiqueta demasiado larga: " + string(etiqueta.substr(0, 32)) + "...");
+        }
+        desplazamientos.push_back(posicion + bufer.size());
+        bufer.push_back((char)n);
+        bufer.push_back((char)motivo);
+        anadirEntero(etiqueta.size(), 2);
+        bufer.append(etiqueta.data(), etiqueta.size());
+    }
+
+public:
+    explicit EscritorBinario(const string& ruta) : archivo(ruta, ios::binary | ios::trunc) {
+        if (!archivo.is_open()) {
+            throw runtime_error("No se pudo crear archivo: " + ruta);
+        }
+        bufer.append(FIRMA_BINARIA, sizeof(FIRMA_BINARIA));
+        anadirEntero(VERSION_FORMATO_BINARIO, 4);
+        anadirEntero(0, 8);
+        anadirEntero(0, 8);
+        volcarBufer();
+    }
+
+    ~EscritorBinario() override {
+        if (archivo.is_open()) {
+            try { cerrar(); } catch (...) {}
+        }
+    }
+
+    /**
+     * Añade un tablero de tamano x tamano dado por filas (0 = vacía)
+     */
+    void escribir(string_view etiqueta, const int* celdas, int n) override {
+        anadirCabeceraRegistro(etiqueta, n);
+        empaquetarCeldas(celdas, n, bufer);
+
+        if (bufer.size() >= (1 << 16)) volcarBufer();
+    }
+
+    /**
+     * Añade un bloque sin tablero ("Sin solucion" o "Tiempo agotado")
+     */
+    void escribirSinTablero(string_view etiqueta, int motivo = MOTIVO_SIN_SOLUCION) override {
+        anadirCabeceraRegistro(etiqueta, 0, motivo);
+        if (bufer.size() >= (1 << 16)) volcarBufer();
+    }
+
+    void cerrar() override {
+        volcarBufer();
+        uint64_t indice = posicion;
+        for (uint64_t d : desplazamientos) {
+            anadirEntero(d, 8);
+        }
+        volcarBufer();
+
+        archivo.seekp(8);
+        anadirEntero(desplazamientos.size(), 8);
+        anadirEntero(indice, 8);
+        archivo.write(bufer.data(), bufer.size());
+        bufer.clear();
+        archivo.close();
+    }
+};
+
+/**
+ * Acceso a un archivo binario ya cargado o mapeado en memoria. Permite
+ * recorrerlo en orden o decodificar cualquier registro por su índice.
+ */
+class LectorBinario {
+private:
+    const char* datos;
+    size_t largo;
+    uint64_t cantidad = 0;
+    const char* indice = nullptr;
+    vector<uint64_t> indiceReconstruido;
+
+    [[noreturn]] static void corrupto() {
+        throw runtime_error("Archivo binario corrupto");
+    }
+
+    /**
+     * Valida el registro en 'desplazamiento' y devuelve dónde termina
+     */
+    size_t finDeRegistro(size_t desplazamiento) const {
+        // Se compara con lo que queda del archivo: un desplazamiento dañado
+        // cerca de SIZE_MAX no debe desbordar la suma
+        if (desplazamiento > largo || largo - desplazamiento < 4) corrupto();
+        int n = (uint8_t)datos[desplazamiento];
+        size_t contenido = leerEntero(datos + desplazamiento + 2, 2);
+        if (n > 0) contenido += bytesCeldas(n);
+        if (contenido > largo - desplazamiento - 4) corrupto();
+        return desplazamiento + 4 + contenido;
+    }
+
+public:
+    LectorBinario(const char* datosArchivo, size_t largoArchivo) : datos(datosArchivo), largo(largoArchivo) {
+        if (largo < TAMANO_CABECERA_BINARIA || !esFormatoBinario(datos, largo)) corrupto();
+        if (leerEntero(datos + 4, 4) != VERSION_FORMATO_BINARIO) {
+            throw runtime_error("Version de formato binario no soportada");
+        }
+
+        cantidad = leerEntero(datos + 8, 8);
+        uint64_t desplazamientoIndice = leerEntero(datos + 16, 8);
+
+        if (desplazamientoIndice == 0) {
+            // Archivo sin cerrar: se recuperan los registros completos
+            size_t p = TAMANO_CABECERA_BINARIA;
+            while (p + 4 <= largo) {
+                int n = (uint8_t)datos[p];
+                size_t fin = p + 4 + leerEntero(datos + p + 2, 2) + (n > 0 ? bytesCeldas(n) : 0);
+                if (fin > largo) break;
+                indiceReconstruido.push_back(p);
+                p = fin;
+            }
+            cantidad = indiceReconstruido.size();
+        } else {
+            if (desplazamientoIndice > largo || (largo - desplazamientoIndice) / 8 < cantidad) corrupto();
+            indice = datos + desplazamientoIndice;
+        }
+    }
+
+    size_t obtenerCantidad() const {
+        return cantidad;
+    }
+
+    /**
+     * Decodifica el registro 'i' en 'celdas' (tamano * tamano valores por
+     * filas). Devuelve n, o 0 si el registro no tiene tablero.
+     */
+    int leer(size_t i, string_view& etiqueta, vector<int>& celdas) const {
+        int motivo;
+        return leer(i, etiqueta, celdas, motivo);
+    }
+    
+    /**
+     * Igual, pero devuelve también el motivo de los registros sin tablero
+     */
+    int leer(size_t i, string_view& etiqueta, vector<int>& celdas, int& motivo) const {
+        if (i >= cantidad) throw out_of_range("Registro fuera de rango");
+        size_t desplazamiento = indice ? leerEntero(indice + 8 * i, 8) : indiceReconstruido[i];
+        finDeRegistro(desplazamiento);
+
+        const char* p = datos + desplazamiento;
+        int n = (uint8_t)p[0];
+        motivo = n == 0 ? (int)(uint8_t)p[1] : (int)MOTIVO_SIN_SOLUCION;
+        size_t largoEtiqueta = leerEntero(p + 2, 2);
+        etiqueta = string_view(p + 4, largoEtiqueta);
+        if (n == 0) return 0;
+
+        size_t tamano = (size_t)n * n;
+        celdas.resize(tamano * tamano);
+        if (!desempaquetarCeldas((const uint8_t*)(p + 4 + largoEtiqueta), n, celdas.data())) {
+            corrupto();
+        }
+        return n;
+    }
+};
+
+#endif
@@ -0,0 +1,287 @@
+#ifndef GENERADOR_SUDOKUS_H
+#define GENERADOR_SUDOKUS_H
+
+#include <vector>
+#include <random>
+#include <memory>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+
+#include "MotoresSudoku.h"
+
+using namespace std;
+
+/**
+ * Generador de sudokus válidos con solución única, compartido por
+ * sudoku-nxn-gen.cpp y Rendimiento.cpp.
+ *
+ * 1. Solución completa: los bloques de la diagonal no comparten filas ni
+ *    columnas, así que se rellenan al azar y el motor híbrido completa
+ *    el resto. Después se baraja con transformaciones que conservan la
+ *    validez (símbolos, filas dentro de su banda, bandas, columnas,
+ *    pilas y trasposición).
+ * 2. Excavación: se quitan pistas en orden aleatorio y cada retirada se
+ *    acepta solo si el motor en modo conteo (máximo 2) sigue encontrando
+ *    una única solución. Las pistas que el resto fuerza como single
+ *    desnudo u oculto se quitan sin llamar al motor: con máscaras de
+ *    las pistas por fila, columna y bloque la prueba cuesta unas pocas
+ *    operaciones y evita la mitad de las comprobaciones.
+ *
+ * Cada sudoku depende solo de su semilla, así que el resultado no
+ * depende del orden ni del hilo en que se genere. Un generador no es
+ * seguro entre hilos: cada hilo usa el suyo.
+ */
+class GeneradorSudokus {
+private:
+    int n;
+    int tamano;
+    int celdas;
+    int pistasMinimas = 0;
+    long long comprobaciones = 0;
+
+    mt19937_64 azar;
+    unique_ptr<ResolvedorSudoku> completador;
+    unique_ptr<ResolvedorSudoku> verificador;
+    vector<int> orden;
+    // Valores presentes entre las pistas de cada fila, columna y bloque
+    vector<uint32_t> filaUsada, colUsada, bloqueUsado;
+    vector<int> auxiliar;
+
+    int aleatorio(int limite) {
+        return (int)(azar() % (uint64_t)limite);
+    }
+
+    void rellenarDiagonal(vector<int>& tablero) {
+        fill(tablero.begin(), tablero.end(), 0);
+        vector<int> valores(tamano);
+        iota(valores.begin(), valores.end(), 1);
+
+        for (int b = 0; b < n; b++) {
+            shuffle(valores.begin(), valores.end(), azar);
+            for (int k = 0; k < tamano; k++) {
+                int fila = b * n + k / n;
+                int col = b * n + k % n;
+                tablero[fila * tamano + col] = valores[k];
+            }
+        }
+    }
+
+    /**
+     * Permutación aleatoria de 0..tamano-1 que solo mueve líneas dentro
+     * de su banda y bandas enteras
+     */
+    vector<int> permutacionPorBandas() {
+        vector<int> bandas(n), dentro(n), resultado;
+        iota(bandas.begin(), bandas.end(), 0);
+        shuffle(bandas.begin(), bandas.end(), azar);
+
+        for (int b : bandas) {
+            iota(dentro.begin(), dentro.end(), 0);
+            shuffle(dentro.begin(), dentro.end(), azar);
+            for (int k : dentro) {
+                resultado.push_back(b * n + k);
+            }
+        }
+        return resultado;
+    }
+
+    void barajar(vector<int>& tablero) {
+        vector<int> simbolos(tamano + 1);
+        iota(simbolos.begin(), simbolos.end(), 0);
+        shuffle(simbolos.begin() + 1, simbolos.end(), azar);
+
+        vector<int> filas = permutacionPorBandas();
+        vector<int> columnas = permutacionPorBandas();
+        bool trasponer = azar() & 1;
+
+        auxiliar.resize(celdas);
+        for (int i = 0; i < tamano; i++) {
+            for (int j = 0; j < tamano; j++) {
+                int origen = trasponer ? columnas[j] * tamano + filas[i] : filas[i] * tamano + columnas[j];
+                auxiliar[i * tamano + j] = simbolos[tablero[origen]];
+            }
+        }
+        tablero.swap(auxiliar);
+    }
+
+    uint32_t bitValor(int valor) const {
+        return 1u << (valor - 1);
+    }
+
+    int bloqueDe(int celda) const {
+        return (celda / tamano / n) * n + (celda % tamano) / n;
+    }
+
+    void quitarPista(vector<int>& sudoku, int celda) {
+        uint32_t bit = bitValor(sudoku[celda]);
+        filaUsada[celda / tamano] &= ~bit;
+        colUsada[celda % tamano] &= ~bit;
+        bloqueUsado[bloqueDe(celda)] &= ~bit;
+        sudoku[celda] = 0;
+    }
+
+    void ponerPista(vector<int>& sudoku, int celda, int valor) {
+        uint32_t bit = bitValor(valor);
+        filaUsada[celda / tamano] |= bit;
+        colUsada[celda % tamano] |= bit;
+        bloqueUsado[bloqueDe(celda)] |= bit;
+        sudoku[celda] = valor;
+    }
+
+    /**
+     * true si 'valor' no está en la fila, columna ni bloque de la celda
+     */
+    bool cabe(int celda, uint32_t bit) const {
+        return !((filaUsada[celda / tamano] | colUsada[celda % tamano] | bloqueUsado[bloqueDe(celda)]) & bit);
+    }
+
+    /**
+     * Con la pista de 'celda' ya quitada: true si las demás pistas la
+     * fuerzan, porque es un single desnudo (ningún otro valor cabe) o un
+     * single oculto de su fila, columna o bloque (su valor no cabe en
+     * ninguna otra celda vacía de la unidad). Entonces la retirada no
+     * cambia las soluciones y no hace falta comprobar la unicidad.
+     */
+    bool forzadaPorPistas(const vector<int>& sudoku, int celda, int valor) const {
+        uint32_t bit = bitValor(valor);
+        uint32_t libres = ~(filaUsada[celda / tamano] | colUsada[celda % tamano] | bloqueUsado[bloqueDe(celda)]);
+        if ((libres & ((1u << tamano) - 1)) == bit) {
+            return true;
+        }
+
+        int fila = celda / tamano, col = celda % tamano;
+        int filaBloque = fila - fila % n, colBloque = col - col % n;
+        bool enFila = true, enCol = true, enBloque = true;
+        for (int k = 0; k < tamano && (enFila || enCol || enBloque); k++) {
+            int otraFila = fila * tamano + k;
+            int otraCol = k * tamano + col;
+            int otraBloque = (filaBloque + k / n) * tamano + colBloque + k % n;
+            if (enFila && otraFila != celda && sudoku[otraFila] == 0 && cabe(otraFila, bit)) enFila = false;
+            if (enCol && otraCol != celda && sudoku[otraCol] == 0 && cabe(otraCol, bit)) enCol = false;
+            if (enBloque && otraBloque != celda && sudoku[otraBloque] == 0 && cabe(otraBloque, bit)) enBloque = false;
+        }
+        return enFila || enCol || enBloque;
+    }
+
+    /**
+     * Un límite agotado cuenta como no única: la pista se conserva
+     */
+    bool esUnico(const vector<int>& tablero) {
+        comprobaciones++;
+        verificador->cargarSudoku(tablero.data(), n);
+        verificador->resolverSudoku();
+        return verificador->obtenerSoluciones() == 1 && !verificador->limiteAgotado();
+    }
+
+public:
+    /**
+     * 'limiteNodos' acota cada comprobación de unicidad (0 = sin límite);
+     * solo hace falta en tableros grandes
+     */
+    explicit GeneradorSudokus(int nParam, long long limiteNodos = 0) : n(nParam), tamano(nParam * nParam),
+                                                                         celdas(nParam * nParam * nParam * nParam) {
+        if (n < 2 || n > 5) {
+            throw invalid_argument("Orden no soportado: " + to_string(n) + " (admitidos 2..5)");
+        }
+
+        completador = crearResolvedor("hibrido");
+
+        LimitesBusqueda limites;
+        limites.nodos = limiteNodos;
+        // Las comprobaciones son cortas: en 9x9 bastan los singles y las
+        // técnicas caras cuestan más de lo que podan; en tableros grandes
+        // compensan los candidatos bloqueados
+        TecnicasPropagacion tecnicas;
+        tecnicas.candidatosBloqueados = n >= 4;
+        tecnicas.subconjuntosDesnudos = false;
+        tecnicas.subconjuntosOcultos = false;
+        verificador = crearResolvedor("hibrido", tecnicas, 1, false, limites);
+        verificador->configurarConteo(2);
+
+        orden.resize(celdas);
+    }
+
+    /**
+     * Semilla del sudoku 'indice' de un lote (splitmix64): semillas de
+     * lote consecutivas dan sudokus sin relación entre sí
+     */
+    static uint64_t semillaDe(uint64_t semillaLote, uint64_t indice) {
+        uint64_t z = semillaLote + (indice + 1) * 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * Deja de quitar pistas al llegar a 'pistas' (0 = quitar todas las
+     * posibles, hasta un sudoku mínimo)
+     */
+    void establecerPistasMinimas(int pistas) {
+        pistasMinimas = max(0, pistas);
+    }
+
+    /**
+     * Genera en 'sudoku' (tamano * tamano valores por filas, 0 = vacía)
+     * un sudoku de solución única; si 'solucion' no es nulo recibe su
+     * solución. Devuelve la cantidad de pistas.
+     */
+    int generar(uint64_t semilla, vector<int>& sudoku, vector<int>* solucion = nullptr) {
+        azar.seed(semilla);
+        sudoku.resize(celdas);
+
+        // En 4x4 algunas diagonales no se pueden completar: se sortea otra
+        for (int intento = 0; ; intento++) {
+            rellenarDiagonal(sudoku);
+            completador->cargarSudoku(sudoku.data(), n);
+            if (completador->resolverSudoku()) break;
+            if (intento == 100) {
+                throw runtime_error("No se pudo completar el tablero inicial");
+            }
+        }
+        completador->copiarSolucion(sudoku.data());
+        barajar(sudoku);
+        if (solucion) {
+            *solucion = sudoku;
+        }
+
+        iota(orden.begin(), orden.end(), 0);
+        shuffle(orden.begin(), orden.end(), azar);
+
+        filaUsada.assign(tamano, 0);
+        colUsada.assign(tamano, 0);
+        bloqueUsado.assign(tamano, 0);
+        for (int celda = 0; celda < celdas; celda++) {
+            ponerPista(sudoku, celda, sudoku[celda]);
+        }
+
+        int pistas = celdas;
+        for (int celda : orden) {
+            if (pistas <= pistasMinimas) break;
+
+            int valor = sudoku[celda];
+            quitarPista(sudoku, celda);
+            if (forzadaPorPistas(sudoku, celda, valor) || esUnico(sudoku)) {
+                pistas--;
+            } else {
+                ponerPista(sudoku, celda, valor);
+            }
+        }
+
+        return pistas;
+    }
+
+    int obtenerN() const {
+        return n;
+    }
+
+    /**
+     * Comprobaciones de unicidad hechas desde que se creó el generador
+     */
+    long long obtenerComprobaciones() const {
+        return comprobaciones;
+    }
+};
+
+#endif
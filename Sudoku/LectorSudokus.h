@@ -0,0 +1,413 @@
+#ifndef LECTOR_SUDOKUS_H
+#define LECTOR_SUDOKUS_H
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "FormatoBinario.h"
+
+using namespace std;
+
+/**
+ * Vista de un bloque recién decodificado. 'etiqueta' apunta al archivo
+ * mapeado y 'celdas' a un búfer del lector que se reutiliza en el
+ * siguiente bloque: solo son válidos durante la llamada.
+ */
+struct TableroPlano {
+    string_view etiqueta;
+    const int* celdas;      // tamano * tamano valores por filas; nullptr si no hay tablero
+    int n;
+    int tamano;
+    int motivo;             // MotivoSinTablero si no hay tablero
+};
+
+/**
+ * Archivo proyectado en memoria de solo lectura (mmap o
+ * CreateFileMapping según la plataforma)
+ */
+class ArchivoMapeado {
+private:
+    const char* datos = nullptr;
+    size_t tamanoBytes = 0;
+#ifdef _WIN32
+    HANDLE archivo = INVALID_HANDLE_VALUE;
+    HANDLE mapeo = nullptr;
+#endif
+
+public:
+    explicit ArchivoMapeado(const string& ruta) {
+#ifdef _WIN32
+        archivo = CreateFileA(ruta.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (archivo == INVALID_HANDLE_VALUE) {
+            throw runtime_error("No se pudo abrir el archivo: " + ruta);
+        }
+        LARGE_INTEGER largo;
+        GetFileSizeEx(archivo, &largo);
+        tamanoBytes = (size_t)largo.QuadPart;
+        if (tamanoBytes == 0) return;
+
+        mapeo = CreateFileMappingA(archivo, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapeo != nullptr) {
+            datos = (const char*)MapViewOfFile(mapeo, FILE_MAP_READ, 0, 0, 0);
+        }
+        if (datos == nullptr) {
+            liberar();
+            throw runtime_error("No se pudo mapear el archivo: " + ruta);
+        }
+#else
+        int fd = open(ruta.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("No se pudo abrir el archivo: " + ruta);
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            close(fd);
+            throw runtime_error("No se pudo abrir el archivo: " + ruta);
+        }
+        tamanoBytes = (size_t)info.st_size;
+        if (tamanoBytes == 0) {
+            close(fd);
+            return;
+        }
+
+        void* p = mmap(nullptr, tamanoBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) {
+            throw runtime_error("No se pudo mapear el archivo: " + ruta);
+        }
+        madvise(p, tamanoBytes, MADV_SEQUENTIAL);
+        datos = (const char*)p;
+#endif
+    }
+
+    ~ArchivoMapeado() {
+        liberar();
+    }
+
+    ArchivoMapeado(const ArchivoMapeado&) = delete;
+    ArchivoMapeado& operator=(const ArchivoMapeado&) = delete;
+
+    const char* inicio() const { return datos; }
+    size_t tamano() const { return tamanoBytes; }
+
+private:
+    void liberar() {
+#ifdef _WIN32
+        if (datos) UnmapViewOfFile(datos);
+        if (mapeo) CloseHandle(mapeo);
+        if (archivo != INVALID_HANDLE_VALUE) CloseHandle(archivo);
+        mapeo = nullptr;
+        archivo = INVALID_HANDLE_VALUE;
+#else
+        if (datos) munmap((void*)datos, tamanoBytes);
+#endif
+        datos = nullptr;
+    }
+};
+
+/**
+ * Lector de archivos con varios sudokus etiquetados ("k-Sudoku #i"
+ * seguido de n² líneas de símbolos de ancho fijo, '-' = celda vacía).
+ * Compartido por Resolver.cpp y Validar.cpp. Los archivos en formato
+ * binario (FormatoBinario.h) se reconocen por su firma.
+ *
+ * El archivo se mapea en memoria y se recorre sin copiar líneas: las
+ * líneas son vistas sobre el mapeo y los símbolos se decodifican
+ * directamente en un búfer plano reutilizado entre bloques.
+ */
+class LectorSudokus {
+private:
+    vector<string_view> lineasSudoku;
+    vector<int> celdas;
+    size_t bytesLeidos = 0;
+    bool entregarInvalidos = false;
+
+    static bool esEspacio(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    static string_view trim(const char* desde, const char* hasta) {
+        while (desde < hasta && esEspacio(*desde)) desde++;
+        while (hasta > desde && esEspacio(hasta[-1])) hasta--;
+        return string_view(desde, hasta - desde);
+    }
+
+    static bool esEtiqueta(string_view linea) {
+        return linea.find("Sudoku") != string_view::npos ||
+               linea.find("sudoku") != string_view::npos ||
+               (!linea.empty() && linea.back() == '#');
+    }
+
+    static int anchoDe(int tamano) {
+        int ancho = 1;
+        for (int limite = 10; tamano >= limite; limite *= 10) ancho++;
+        return ancho;
+    }
+
+    /**
+     * Decodifica un símbolo como lo hacía stoi: '-' en cualquier posición
+     * es celda vacía, se aceptan espacios iniciales y un signo '+', y se
+     * leen dígitos hasta el primer carácter que no lo sea (0 si no hay)
+     */
+    static int decodificarSimbolo(const char* s, int largo) {
+        if (memchr(s, '-', largo) != nullptr) return 0;
+
+        int i = 0;
+        while (i < largo && esEspacio(s[i])) i++;
+        if (i < largo && s[i] == '+') i++;
+
+        int valor = 0;
+        for (; i < largo && s[i] >= '0' && s[i] <= '9'; i++) {
+            valor = valor * 10 + (s[i] - '0');
+        }
+        return valor;
+    }
+
+    /**
+     * Un bloque es un tablero si sus líneas solo tienen dígitos y '-'
+     * (las salidas del resolvedor contienen bloques "Sin solucion")
+     */
+    static bool pareceTablero(string_view primera) {
+        for (char c : primera) {
+            if ((c < '0' || c > '9') && c != '-') return false;
+        }
+        return true;
+    }
+
+    /**
+     * Un bloque de dimensiones inválidas se descarta con un aviso o, si
+     * se pidió, se entrega como bloque sin tablero
+     */
+    void descartarInvalido(TableroPlano& sudoku, const function<void(const TableroPlano&)>& alLeer) {
+        if (!entregarInvalidos) {
+            cerr << "Advertencia: " << sudoku.etiqueta << " dimensiones invalidas" << endl;
+            return;
+        }
+        sudoku.n = 0;
+        sudoku.tamano = 0;
+        sudoku.celdas = nullptr;
+        sudoku.motivo = MOTIVO_DIMENSIONES_INVALIDAS;
+        alLeer(sudoku);
+    }
+
+    void procesarSudoku(string_view etiqueta, const function<void(const TableroPlano&)>& alLeer) {
+        TableroPlano sudoku;
+        sudoku.etiqueta = etiqueta;
+        sudoku.celdas = nullptr;
+        sudoku.motivo = MOTIVO_SIN_SOLUCION;
+
+        // Una etiqueta sin líneas solo cuenta si se entregan los inválidos
+        if (lineasSudoku.empty()) {
+            if (entregarInvalidos) descartarInvalido(sudoku, alLeer);
+            return;
+        }
+
+        if (!pareceTablero(lineasSudoku[0])) {
+            sudoku.n = 0;
+            sudoku.tamano = 0;
+            if (lineasSudoku[0] == textoMotivo(MOTIVO_TIEMPO_AGOTADO)) {
+                sudoku.motivo = MOTIVO_TIEMPO_AGOTADO;
+            }
+            alLeer(sudoku);
+            return;
+        }
+
+        int tamano = (int)lineasSudoku.size();
+        int n = 1;
+        while ((n + 1) * (n + 1) <= tamano) n++;
+
+        if (n * n != tamano) {
+            descartarInvalido(sudoku, alLeer);
+            return;
+        }
+
+        int ancho = anchoDe(tamano);
+        celdas.resize((size_t)tamano * tamano);
+        int* destino = celdas.data();
+
+        for (string_view linea : lineasSudoku) {
+            // Cantidad de símbolos de la línea, contando el último aunque esté truncado
+            size_t simbolos = (linea.size() + ancho - 1) / ancho;
+            if (simbolos != (size_t)tamano) {
+                descartarInvalido(sudoku, alLeer);
+                return;
+            }
+
+            const char* p = linea.data();
+            if (ancho == 1) {
+                for (int j = 0; j < tamano; j++) {
+                    char c = p[j];
+                    destino[j] = (c >= '0' && c <= '9') ? c - '0' : 0;
+                }
+            } else {
+                for (int j = 0; j < tamano; j++) {
+                    int largo = (int)min<size_t>(ancho, linea.size() - (size_t)j * ancho);
+                    destino[j] = decodificarSimbolo(p + (size_t)j * ancho, largo);
+                }
+            }
+            destino += tamano;
+        }
+
+        sudoku.n = n;
+        sudoku.tamano = tamano;
+        sudoku.celdas = celdas.data();
+        alLeer(sudoku);
+    }
+
+    void leerBinario(const char* datos, size_t largo, const function<void(const TableroPlano&)>& alLeer) {
+        LectorBinario binario(datos, largo);
+        size_t cantidad = binario.obtenerCantidad();
+
+        for (size_t i = 0; i < cantidad; i++) {
+            TableroPlano sudoku;
+            sudoku.n = binario.leer(i, sudoku.etiqueta, celdas, sudoku.motivo);
+            sudoku.tamano = sudoku.n * sudoku.n;
+            sudoku.celdas = sudoku.n > 0 ? celdas.data() : nullptr;
+            alLeer(sudoku);
+        }
+    }
+
+    /**
+     * Recorre bloques de texto etiquetados entre 'p' y 'fin'. En modo
+     * parcial solo se leen líneas completas, el último bloque no se cierra
+     * por llegar al final y se devuelve dónde empieza lo que falta por
+     * entregar (el bloque a medias, si lo hay); si no, se devuelve 'fin'.
+     */
+    const char* recorrerTexto(const char* p, const char* fin, bool parcial,
+                              const function<void(const TableroPlano&)>& alLeer) {
+        string_view etiquetaActual;
+        int lineasEsperadas = -1;
+        lineasSudoku.clear();
+        const char* pendiente = p;
+
+        while (p < fin) {
+            const char* salto = (const char*)memchr(p, '\n', fin - p);
+            if (!salto && parcial) break;
+            const char* finLinea = salto ? salto : fin;
+            const char* inicioLinea = p;
+            string_view linea = trim(p, finLinea);
+            p = salto ? salto + 1 : fin;
+
+            // Verificar si es una etiqueta
+            if (esEtiqueta(linea)) {
+                // Procesar sudoku anterior si existe
+                if (!etiquetaActual.empty()) {
+                    procesarSudoku(etiquetaActual, alLeer);
+                    lineasSudoku.clear();
+                }
+
+                etiquetaActual = linea;
+                lineasEsperadas = -1;
+                pendiente = inicioLinea;
+            }
+            else if (!linea.empty() && !etiquetaActual.empty()) {
+                lineasSudoku.push_back(linea);
+
+                // Determinar tamaño esperado
+                if (lineasEsperadas == -1) {
+                    for (int n = 2; n <= 10; n++) {
+                        int t = n * n;
+                        if (linea.size() == (size_t)(t * anchoDe(t))) {
+                            lineasEsperadas = t;
+                            break;
+                        }
+                    }
+                }
+
+                // Procesar cuando tengamos todas las líneas
+                if (lineasEsperadas > 0 && (int)lineasSudoku.size() == lineasEsperadas) {
+                    procesarSudoku(etiquetaActual, alLeer);
+                    lineasSudoku.clear();
+                    etiquetaActual = string_view();
+                    lineasEsperadas = -1;
+                    pendiente = p;
+                }
+            }
+            else if (etiquetaActual.empty()) {
+                pendiente = p;
+            }
+        }
+
+        if (parcial) {
+            lineasSudoku.clear();
+            return etiquetaActual.empty() ? p : pendiente;
+        }
+
+        // Procesar último sudoku
+        if (!etiquetaActual.empty()) {
+            procesarSudoku(etiquetaActual, alLeer);
+        }
+        lineasSudoku.clear();
+        return fin;
+    }
+
+public:
+    /**
+     * Entrega los bloques de dimensiones inválidas (y las etiquetas sin
+     * líneas) como bloques sin tablero con MOTIVO_DIMENSIONES_INVALIDAS,
+     * sin avisar por cerr, para quien deba responder a cada bloque
+     */
+    void configurarInvalidos(bool entregar) {
+        entregarInvalidos = entregar;
+    }
+
+    /**
+     * Recorre el archivo y entrega cada bloque etiquetado a 'alLeer' como
+     * un tablero plano, en orden y sin guardar el resto. Los bloques sin
+     * tablero llegan con tamano 0; los de dimensiones inválidas se
+     * descartan con un aviso.
+     */
+    void leerArchivoPlano(const string& archivo, const function<void(const TableroPlano&)>& alLeer) {
+        ArchivoMapeado mapeo(archivo);
+        leerBufer(mapeo.inicio(), mapeo.tamano(), alLeer);
+    }
+
+    /**
+     * Igual que leerArchivoPlano sobre un búfer ya en memoria, de texto o
+     * con el formato binario
+     */
+    void leerBufer(const char* datos, size_t largo, const function<void(const TableroPlano&)>& alLeer) {
+        if (esFormatoBinario(datos, largo)) {
+            leerBinario(datos, largo, alLeer);
+        } else {
+            recorrerTexto(datos, datos + largo, false, alLeer);
+        }
+        bytesLeidos += largo;
+    }
+
+    /**
+     * Entrega los bloques de texto completos de un búfer que sigue
+     * creciendo (p. ej. lo recibido por un socket) y devuelve los bytes
+     * consumidos; el resto debe volver a pasarse cuando llegue más. Un
+     * bloque termina al completar sus filas o al empezar otra etiqueta.
+     */
+    size_t leerBloquesCompletos(const char* datos, size_t largo,
+                                const function<void(const TableroPlano&)>& alLeer) {
+        return recorrerTexto(datos, datos + largo, true, alLeer) - datos;
+    }
+
+    /**
+     * Bytes recorridos desde que se creó el lector (para medir MB/s)
+     */
+    size_t obtenerBytesLeidos() const {
+        return bytesLeidos;
+    }
+};
+
+#endif
@@ -0,0 +1,1847 @@
+#ifndef MOTORES_SUDOKU_H
+#define MOTORES_SUDOKU_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <cstdint>
+#include <type_traits>
+#include <stdexcept>
+#include <chrono>
+#include <cmath>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "ValidadorBits.h"
+
+using namespace std;
+
+/**
+ * Técnicas de propagación activables en el resolvedor híbrido
+ */
+struct TecnicasPropagacion {
+    bool singlesDesnudos = true;
+    bool singlesOcultos = true;
+    bool candidatosBloqueados = true;   // pointing y claiming
+    bool subconjuntosDesnudos = true;   // pares y tríos desnudos
+    bool subconjuntosOcultos = true;    // pares y tríos ocultos
+};
+
+/**
+ * Aciertos por técnica: asignaciones (singles) o celdas podadas (resto)
+ */
+struct ContadoresTecnicas {
+    long long singlesDesnudos = 0;
+    long long singlesOcultos = 0;
+    long long candidatosBloqueados = 0;
+    long long subconjuntosDesnudos = 0;
+    long long subconjuntosOcultos = 0;
+    
+    void acumular(const ContadoresTecnicas& otro) {
+        singlesDesnudos += otro.singlesDesnudos;
+        singlesOcultos += otro.singlesOcultos;
+        candidatosBloqueados += otro.candidatosBloqueados;
+        subconjuntosDesnudos += otro.subconjuntosDesnudos;
+        subconjuntosOcultos += otro.subconjuntosOcultos;
+    }
+};
+
+/**
+ * Métricas de la búsqueda de un sudoku. Solo las llena el motor híbrido
+ * con estadísticas activas; el resto de motores las deja en cero.
+ */
+struct EstadisticasBusqueda {
+    static const int MAX_RAMIFICACION = 32;
+    
+    long long retrocesos = 0;                   // candidatos descartados tras explorar su subárbol
+    int profundidadMaxima = 0;                  // decisiones de ramificación apiladas
+    long long asignacionesPropagacion = 0;      // singles desnudos y ocultos
+    long long asignacionesRamificacion = 0;
+    long long ramificacion[MAX_RAMIFICACION + 1] = {};   // celdas MRV por candidatos (el último, 32 o más)
+    double segundosPropagacion = 0;
+    double segundosBusqueda = 0;                // tiempo total menos propagación
+    
+    // Decisiones en el camino de la raíz a la solución y suma de log2 de
+    // sus candidatos: log2 del tamaño del árbol según la estimación de
+    // Knuth. En la búsqueda paralela solo cuentan las decisiones por
+    // debajo de la profundidad de división.
+    int decisionesCamino = 0;
+    double bitsCamino = 0;
+    
+    void acumular(const EstadisticasBusqueda& otro) {
+        retrocesos += otro.retrocesos;
+        profundidadMaxima = max(profundidadMaxima, otro.profundidadMaxima);
+        asignacionesPropagacion += otro.asignacionesPropagacion;
+        asignacionesRamificacion += otro.asignacionesRamificacion;
+        for (int k = 0; k <= MAX_RAMIFICACION; k++) {
+            ramificacion[k] += otro.ramificacion[k];
+        }
+        segundosPropagacion += otro.segundosPropagacion;
+        segundosBusqueda += otro.segundosBusqueda;
+        decisionesCamino += otro.decisionesCamino;
+        bitsCamino += otro.bitsCamino;
+    }
+};
+
+/**
+ * Límites de la búsqueda de cada sudoku (0 = sin límite)
+ */
+struct LimitesBusqueda {
+    double segundos = 0;
+    long long nodos = 0;
+};
+
+/**
+ * Control de los límites dentro del bucle de búsqueda. Es barato: los
+ * nodos se comparan en cada llamada, pero el reloj solo se consulta cada
+ * 'periodo' nodos. El periodo se ajusta a lo que cuesta un nodo para que
+ * entre dos consultas pasen unos INTERVALO_RELOJ segundos: en 9x9 llega a
+ * PERIODO_MAXIMO y en tableros grandes, donde un nodo puede costar
+ * cientos de microsegundos, baja hasta consultar en cada nodo.
+ */
+class PresupuestoBusqueda {
+private:
+    static const long long PERIODO_MAXIMO = 256;
+    static constexpr double INTERVALO_RELOJ = 20e-6;
+    
+    LimitesBusqueda limites;
+    chrono::steady_clock::time_point plazo;
+    chrono::steady_clock::time_point ultimaConsulta;
+    long long periodo = 1;
+    long long proximaConsulta = 0;
+    bool agotado = false;
+    
+    bool plazoVencido(long long nodos) {
+        auto ahora = chrono::steady_clock::now();
+        double transcurrido = chrono::duration<double>(ahora - ultimaConsulta).count();
+        if (transcurrido < INTERVALO_RELOJ / 2 && periodo < PERIODO_MAXIMO) {
+            periodo *= 2;
+        } else if (transcurrido > INTERVALO_RELOJ && periodo > 1) {
+            periodo /= 2;
+        }
+        ultimaConsulta = ahora;
+        proximaConsulta = nodos + periodo;
+        return ahora >= plazo;
+    }
+    
+public:
+    void configurar(const LimitesBusqueda& nuevos) {
+        limites = nuevos;
+    }
+    
+    const LimitesBusqueda& obtenerLimites() const {
+        return limites;
+    }
+    
+    // Arranca el reloj al empezar cada sudoku
+    void iniciar() {
+        agotado = false;
+        if (limites.segundos > 0) {
+            ultimaConsulta = chrono::steady_clock::now();
+            plazo = ultimaConsulta +
+                    chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double>(limites.segundos));
+            periodo = 1;
+            proximaConsulta = 0;
+        }
+    }
+    
+    /**
+     * Reparte el límite de nodos entre varias copias que buscan a la vez;
+     * la copia cuenta sus nodos desde cero
+     */
+    void repartirNodos(int partes) {
+        if (limites.nodos > 0) {
+            limites.nodos = max(1LL, limites.nodos / max(1, partes));
+        }
+        proximaConsulta = 0;
+    }
+    
+    bool excedido(long long nodos) {
+        if (agotado) return true;
+        if (limites.nodos > 0 && nodos >= limites.nodos) {
+            agotado = true;
+        } else if (limites.segundos > 0 && nodos >= proximaConsulta && plazoVencido(nodos)) {
+            agotado = true;
+        }
+        return agotado;
+    }
+    
+    void marcarAgotado() {
+        agotado = true;
+    }
+    
+    bool estaAgotado() const {
+        return agotado;
+    }
+};
+
+/**
+ * Resultado de resolver un sudoku del lote
+ */
+struct ResultadoSudoku {
+    bool resuelto = false;
+    bool agotado = false;       // se alcanzó un límite antes de decidir
+    bool reintentado = false;   // lo decidió el motor de reintento
+    bool deCache = false;       // se tomó de la caché de soluciones sin buscar
+    long long nodos = 0;
+    long long soluciones = 0;   // en modo conteo, hasta el máximo pedido
+    double segundos = 0;
+    
+    // Solo se llenan si se piden estadísticas por sudoku
+    ContadoresTecnicas contadores;
+    EstadisticasBusqueda estadisticas;
+};
+
+/**
+ * Interfaz común de los motores de resolución
+ */
+class ResolvedorSudoku {
+public:
+    virtual ~ResolvedorSudoku() {}
+    // 'tablero' y 'destino' son tableros planos de n² x n² valores por filas
+    virtual void cargarSudoku(const int* tablero, int nParam) = 0;
+    virtual bool resolverSudoku() = 0;
+    virtual void copiarSolucion(int* destino) const = 0;
+    virtual long long obtenerNodosExplorados() const = 0;
+    
+    // Solo los motores con propagación llevan contadores
+    virtual ContadoresTecnicas obtenerContadores() const {
+        return ContadoresTecnicas();
+    }
+    
+    virtual EstadisticasBusqueda obtenerEstadisticas() const {
+        return EstadisticasBusqueda();
+    }
+    
+    virtual void configurarLimites(const LimitesBusqueda& limites) {
+        presupuesto.configurar(limites);
+    }
+    
+    // true si la última resolución se cortó por tiempo o nodos
+    virtual bool limiteAgotado() const {
+        return presupuesto.estaAgotado();
+    }
+    
+    /**
+     * Modo conteo: la búsqueda sigue tras la primera solución hasta
+     * encontrar 'maximo' (2 basta para saber si es única). 0 = parar en
+     * la primera, como siempre. La solución que se copia es la primera.
+     */
+    virtual void configurarConteo(long long maximo) {
+        maximoSoluciones = max(0LL, maximo);
+    }
+    
+    // Soluciones encontradas en la última resolución (0 o 1 sin modo conteo)
+    virtual long long obtenerSoluciones() const {
+        return solucionesEncontradas;
+    }
+    
+    // Bytes que ocupa el estado del motor (tableros, máscaras, rastro)
+    virtual size_t obtenerBytesMemoria() const {
+        return 0;
+    }
+    
+protected:
+    PresupuestoBusqueda presupuesto;
+    long long maximoSoluciones = 0;
+    long long solucionesEncontradas = 0;
+};
+
+/**
+ * Operaciones sobre máscaras de candidatos (bit v - 1 = valor v)
+ */
+inline int contarBits(uint32_t mascara) {
+#if defined(_MSC_VER)
+    return __popcnt(mascara);
+#else
+    return __builtin_popcount(mascara);
+#endif
+}
+
+// Menor valor presente en una máscara no vacía
+inline int valorMenor(uint32_t mascara) {
+#if defined(_MSC_VER)
+    unsigned long indice;
+    _BitScanForward(&indice, mascara);
+    return indice + 1;
+#else
+    return __builtin_ctz(mascara) + 1;
+#endif
+}
+
+// Máscara sin su menor valor
+inline uint32_t quitarMenor(uint32_t mascara) {
+    return mascara & (mascara - 1);
+}
+
+/**
+ * Máscara de candidatos de varias palabras de 64 bits para tableros de
+ * 36x36 en adelante (una palabra hasta 64 valores, dos hasta 128). Se
+ * usa como un entero sin signo: el 0 convierte a la máscara vacía.
+ */
+template <int PALABRAS>
+struct MascaraAncha {
+    uint64_t palabras[PALABRAS];
+
+    constexpr MascaraAncha() : palabras() {}
+
+    constexpr MascaraAncha(uint64_t bajos) : palabras() {
+        palabras[0] = bajos;
+    }
+
+    // Bit 'indice' solo (indice < 64 * PALABRAS)
+    static constexpr MascaraAncha bit(int indice) {
+        MascaraAncha m;
+        m.palabras[indice / 64] = 1ULL << (indice % 64);
+        return m;
+    }
+
+    // Los 'cantidad' bits más bajos
+    static constexpr MascaraAncha primeros(int cantidad) {
+        MascaraAncha m;
+        for (int p = 0; p < PALABRAS; p++) {
+            int resto = cantidad - 64 * p;
+            m.palabras[p] = resto >= 64 ? ~0ULL : resto > 0 ? (1ULL << resto) - 1 : 0;
+        }
+        return m;
+    }
+
+    explicit operator bool() const {
+        for (int p = 0; p < PALABRAS; p++) {
+            if (palabras[p]) return true;
+        }
+        return false;
+    }
+
+    MascaraAncha& operator&=(const MascaraAncha& otra) {
+        for (int p = 0; p < PALABRAS; p++) palabras[p] &= otra.palabras[p];
+        return *this;
+    }
+
+    MascaraAncha& operator|=(const MascaraAncha& otra) {
+        for (int p = 0; p < PALABRAS; p++) palabras[p] |= otra.palabras[p];
+        return *this;
+    }
+
+    friend MascaraAncha operator&(MascaraAncha a, const MascaraAncha& b) {
+        return a &= b;
+    }
+
+    friend MascaraAncha operator|(MascaraAncha a, const MascaraAncha& b) {
+        return a |= b;
+    }
+
+    friend MascaraAncha operator~(MascaraAncha a) {
+        for (int p = 0; p < PALABRAS; p++) a.palabras[p] = ~a.palabras[p];
+        return a;
+    }
+
+    friend bool operator==(const MascaraAncha& a, const MascaraAncha& b) {
+        for (int p = 0; p < PALABRAS; p++) {
+            if (a.palabras[p] != b.palabras[p]) return false;
+        }
+        return true;
+    }
+
+    friend bool operator!=(const MascaraAncha& a, const MascaraAncha& b) {
+        return !(a == b);
+    }
+};
+
+template <int PALABRAS>
+inline int contarBits(const MascaraAncha<PALABRAS>& mascara) {
+    int total = 0;
+    for (int p = 0; p < PALABRAS; p++) {
+#if defined(_MSC_VER)
+        total += (int)__popcnt64(mascara.palabras[p]);
+#else
+        total += __builtin_popcountll(mascara.palabras[p]);
+#endif
+    }
+    return total;
+}
+
+template <int PALABRAS>
+inline int valorMenor(const MascaraAncha<PALABRAS>& mascara) {
+    for (int p = 0; p < PALABRAS; p++) {
+        if (mascara.palabras[p]) {
+#if defined(_MSC_VER)
+            unsigned long indice;
+            _BitScanForward64(&indice, mascara.palabras[p]);
+            return 64 * p + indice + 1;
+#else
+            return 64 * p + __builtin_ctzll(mascara.palabras[p]) + 1;
+#endif
+        }
+    }
+    return 0;
+}
+
+template <int PALABRAS>
+inline MascaraAncha<PALABRAS> quitarMenor(MascaraAncha<PALABRAS> mascara) {
+    for (int p = 0; p < PALABRAS; p++) {
+        if (mascara.palabras[p]) {
+            mascara.palabras[p] &= mascara.palabras[p] - 1;
+            break;
+        }
+    }
+    return mascara;
+}
+
+// Máscara con solo el valor 'valor' (1..tamano)
+template <typename Mascara>
+constexpr Mascara bitDeValor(int valor) {
+    if constexpr (is_integral<Mascara>::value) {
+        return (Mascara)(1u << (valor - 1));
+    } else {
+        return Mascara::bit(valor - 1);
+    }
+}
+
+// Máscara con los valores 1..tamano
+template <typename Mascara>
+constexpr Mascara mascaraCompleta(int tamano) {
+    if constexpr (is_integral<Mascara>::value) {
+        return (Mascara)((1u << tamano) - 1);
+    } else {
+        return Mascara::primeros(tamano);
+    }
+}
+
+/**
+ * Tablas de geometría para un orden de bloque N, calculadas en compilación
+ * hasta 25x25. Las celdas se numeran fila * N² + col.
+ */
+template <int N>
+struct TablasSudoku {
+    static constexpr int TAMANO = N * N;
+    static constexpr int CELDAS = TAMANO * TAMANO;
+    static constexpr int VECINOS = 3 * (TAMANO - 1) - 2 * (N - 1);
+    static constexpr int UNIDADES = 3 * TAMANO;
+    
+    // Vecinos (misma fila, columna o bloque) de cada celda
+    int16_t vecinos[CELDAS][VECINOS];
+    // Unidades: filas [0, TAMANO), columnas [TAMANO, 2*TAMANO), bloques después
+    int16_t unidades[UNIDADES][TAMANO];
+    
+    constexpr TablasSudoku() : vecinos(), unidades() {
+        for (int k = 0; k < TAMANO; k++) {
+            int filaInicio = (k / N) * N;
+            int colInicio = (k % N) * N;
+            for (int i = 0; i < TAMANO; i++) {
+                unidades[k][i] = k * TAMANO + i;
+                unidades[TAMANO + k][i] = i * TAMANO + k;
+                unidades[2 * TAMANO + k][i] = (filaInicio + i / N) * TAMANO + colInicio + i % N;
+            }
+        }
+        
+        for (int fila = 0; fila < TAMANO; fila++) {
+            for (int col = 0; col < TAMANO; col++) {
+                int celda = fila * TAMANO + col;
+                int filaInicio = (fila / N) * N;
+                int colInicio = (col / N) * N;
+                int k = 0;
+                
+                for (int j = 0; j < TAMANO; j++) {
+                    if (j != col) vecinos[celda][k++] = fila * TAMANO + j;
+                }
+                for (int i = 0; i < TAMANO; i++) {
+                    if (i != fila) vecinos[celda][k++] = i * TAMANO + col;
+                }
+                for (int i = filaInicio; i < filaInicio + N; i++) {
+                    for (int j = colInicio; j < colInicio + N; j++) {
+                        if (i != fila && j != col) vecinos[celda][k++] = i * TAMANO + j;
+                    }
+                }
+            }
+        }
+    }
+    
+    /**
+     * Tablas compartidas por todos los núcleos de orden N. En tableros
+     * mayores que 25x25 ocuparían megabytes en el ejecutable (279 vecinos
+     * por celda en 100x100), así que se calculan la primera vez que se
+     * piden, en memoria dinámica.
+     */
+    static const TablasSudoku& compartidas() {
+        if constexpr (N <= 5) {
+            static constexpr TablasSudoku tablas{};
+            return tablas;
+        } else {
+            static const unique_ptr<const TablasSudoku> tablas(new TablasSudoku());
+            return *tablas;
+        }
+    }
+};
+
+/**
+ * Parte común de los núcleos híbridos, independiente del tamaño
+ */
+class NucleoHibridoBase : public ResolvedorSudoku {
+public:
+    virtual void configurarTecnicas(const TecnicasPropagacion& activas) = 0;
+    virtual void configurarBusquedaParalela(int hilos, int profundidad) = 0;
+    virtual bool propagarSinRamificar() = 0;
+};
+
+/**
+ * Núcleo híbrido especializado en compilación para bloques N x N:
+ * propagación avanzada + backtracking con MRV sobre un tablero plano
+ * y máscaras de 16 bits (N <= 4), 32 bits (N = 5) o palabras de 64 bits
+ * (N = 6..10).
+ *
+ * En tableros grandes el núcleo guarda un puntero a las tablas dinámicas
+ * y sus cubetas crecen según se llenan: una matriz fija de cubetas
+ * ocuparía TAMANO + 1 veces el tablero (2 MB en 100x100, por cada hilo
+ * de búsqueda).
+ *
+ * Con MEDIR = false las estadísticas de búsqueda no se compilan.
+ */
+template <int N, bool MEDIR = false>
+class NucleoHibrido : public NucleoHibridoBase {
+private:
+    static constexpr int TAMANO = TablasSudoku<N>::TAMANO;
+    static constexpr int CELDAS = TablasSudoku<N>::CELDAS;
+    static constexpr int VECINOS = TablasSudoku<N>::VECINOS;
+    static constexpr int UNIDADES = TablasSudoku<N>::UNIDADES;
+    
+    static constexpr bool GRANDE = N > 5;
+    
+    typedef typename conditional<(TAMANO <= 16), uint16_t,
+            typename conditional<(TAMANO <= 32), uint32_t, MascaraAncha<(TAMANO + 63) / 64>>::type>::type Mascara;
+    static constexpr Mascara TODOS = mascaraCompleta<Mascara>(TAMANO);
+    
+    typedef typename conditional<GRANDE, vector<int16_t>, int16_t[CELDAS]>::type Cubeta;
+    
+    struct EntradaRastro {
+        int16_t celda;
+        bool esAsignacion;          // true: se asignó la celda; false: se podó su máscara
+        Mascara mascaraAnterior;    // solo para podas
+    };
+    
+    enum ResultadoTecnica { CONTRADICCION, SIN_CAMBIOS, CAMBIOS };
+    
+    // Subárbol de la búsqueda paralela: asignaciones (celda, valor) desde la raíz
+    struct Tarea {
+        vector<pair<int, int>> camino;
+    };
+    
+    // Cola de tareas de un trabajador: el dueño saca del final (profundidad
+    // primero) y los ladrones del principio (subárboles más grandes)
+    struct ColaTrabajo {
+        mutex mtx;
+        deque<Tarea> tareas;
+    };
+    
+    uint8_t sudoku[CELDAS];
+    long long nodosExplorados;
+    int celdasVacias;
+    
+    // Modo conteo: primera solución y total compartido por las copias paralelas
+    uint8_t primeraSolucion[CELDAS];
+    atomic<long long>* solucionesGlobales;
+    
+    // Candidatos de cada celda vacía, mantenidos de forma incremental
+    Mascara candidatosCelda[CELDAS];
+    
+    // Celdas vacías agrupadas por número de candidatos (cubeta 0 = contradicción)
+    Cubeta cubetas[TAMANO + 1];
+    int tamanoCubeta[TAMANO + 1];
+    int16_t cubetaDe[CELDAS];
+    int16_t posicionEnCubeta[CELDAS];
+    
+    // Rastro de deshacer: asignaciones y podas de candidatos en orden
+    vector<EntradaRastro> rastro;
+    
+    TecnicasPropagacion tecnicas;
+    ContadoresTecnicas contadores;
+    EstadisticasBusqueda estadisticas;
+    int profundidadActual;
+    
+    // Búsqueda paralela dentro de un mismo sudoku
+    int hilosBusqueda;
+    int profundidadDivision;
+    const atomic<bool>* cancelacion;
+    
+    // Solo en tableros grandes; en el resto las tablas son constantes
+    const TablasSudoku<N>* tablasDinamicas;
+    
+    const TablasSudoku<N>& tablas() const {
+        if constexpr (GRANDE) {
+            return *tablasDinamicas;
+        } else {
+            return TablasSudoku<N>::compartidas();
+        }
+    }
+    
+    void insertarEnCubeta(int celda, int cubeta) {
+        cubetaDe[celda] = cubeta;
+        posicionEnCubeta[celda] = tamanoCubeta[cubeta];
+        if constexpr (GRANDE) {
+            if (cubetas[cubeta].size() == (size_t)tamanoCubeta[cubeta]) {
+                cubetas[cubeta].push_back(0);
+            }
+        }
+        cubetas[cubeta][tamanoCubeta[cubeta]++] = celda;
+    }
+    
+    void sacarDeCubeta(int celda) {
+        int cubeta = cubetaDe[celda];
+        int pos = posicionEnCubeta[celda];
+        int ultima = cubetas[cubeta][--tamanoCubeta[cubeta]];
+        cubetas[cubeta][pos] = ultima;
+        posicionEnCubeta[ultima] = pos;
+    }
+    
+    /**
+     * Quita de una celda vacía todos los candidatos de 'mascara' con una
+     * sola entrada en el rastro
+     */
+    void podarCandidatos(int celda, Mascara mascara) {
+        rastro.push_back({(int16_t)celda, false, candidatosCelda[celda]});
+        candidatosCelda[celda] &= ~mascara;
+        sacarDeCubeta(celda);
+        insertarEnCubeta(celda, contarBits(candidatosCelda[celda]));
+    }
+    
+    /**
+     * Asigna un valor y lo poda de los candidatos de los vecinos vacíos
+     */
+    void colocarValor(int celda, int valor) {
+        sudoku[celda] = valor;
+        celdasVacias--;
+        sacarDeCubeta(celda);
+        rastro.push_back({(int16_t)celda, true, 0});
+        
+        Mascara bit = bitDeValor<Mascara>(valor);
+        for (int k = 0; k < VECINOS; k++) {
+            int vecino = tablas().vecinos[celda][k];
+            if (sudoku[vecino] == 0 && (candidatosCelda[vecino] & bit)) {
+                podarCandidatos(vecino, bit);
+            }
+        }
+    }
+    
+    void quitarValor(int celda) {
+        sudoku[celda] = 0;
+        celdasVacias++;
+        insertarEnCubeta(celda, contarBits(candidatosCelda[celda]));
+    }
+    
+    /**
+     * Deshace asignaciones y podas del rastro hasta dejarlo con 'marca'
+     * entradas. Cada poda guarda la máscara previa, así que el estado
+     * (máscaras y cubetas) vuelve a ser exactamente el de la marca.
+     */
+    void deshacerHasta(size_t marca) {
+        while (rastro.size() > marca) {
+            const EntradaRastro& entrada = rastro.back();
+            int celda = entrada.celda;
+            
+            if (entrada.esAsignacion) {
+                quitarValor(celda);
+            } else {
+                candidatosCelda[celda] = entrada.mascaraAnterior;
+                sacarDeCubeta(celda);
+                insertarEnCubeta(celda, contarBits(candidatosCelda[celda]));
+            }
+            rastro.pop_back();
+        }
+    }
+    
+    /**
+     * Hidden singles: un valor que solo cabe en una celda de la unidad
+     */
+    ResultadoTecnica aplicarSinglesOcultos() {
+        bool hubo = false;
+        
+        for (int u = 0; u < UNIDADES; u++) {
+            Mascara unaVez = 0, variasVeces = 0, colocados = 0;
+            
+            for (int k = 0; k < TAMANO; k++) {
+                int celda = tablas().unidades[u][k];
+                if (sudoku[celda] == 0) {
+                    variasVeces |= unaVez & candidatosCelda[celda];
+                    unaVez |= candidatosCelda[celda];
+                } else {
+                    colocados |= bitDeValor<Mascara>(sudoku[celda]);
+                }
+            }
+            
+            // Un valor sin colocar que ya no cabe en ninguna celda
+            if ((Mascara)(unaVez | colocados) != TODOS) {
+                return CONTRADICCION;
+            }
+            
+            Mascara unicos = unaVez & ~variasVeces;
+            if (unicos == 0) continue;
+            
+            for (int k = 0; k < TAMANO; k++) {
+                int celda = tablas().unidades[u][k];
+                if (sudoku[celda] != 0) continue;
+                
+                Mascara propios = candidatosCelda[celda] & unicos;
+                if (propios != 0) {
+                    colocarValor(celda, valorMenor(propios));
+                    contadores.singlesOcultos++;
+                    hubo = true;
+                }
+            }
+        }
+        
+        return hubo ? CAMBIOS : SIN_CAMBIOS;
+    }
+    
+    /**
+     * Poda 'valores' de las celdas vacías de la unidad que no estén en el
+     * segmento [inicio, inicio + N) de sus posiciones
+     */
+    int podarFueraDeSegmento(int unidad, int inicio, Mascara valores) {
+        int podadas = 0;
+        for (int k = 0; k < TAMANO; k++) {
+            if (k >= inicio && k < inicio + N) continue;
+            
+            int celda = tablas().unidades[unidad][k];
+            if (sudoku[celda] == 0 && (candidatosCelda[celda] & valores)) {
+                podarCandidatos(celda, valores);
+                podadas++;
+            }
+        }
+        return podadas;
+    }
+    
+    /**
+     * Candidatos bloqueados. Pointing: si dentro de un bloque un valor solo
+     * cabe en una fila (o columna), se poda del resto de esa fila. Claiming:
+     * si dentro de una fila (o columna) un valor solo cabe en un bloque, se
+     * poda del resto del bloque.
+     */
+    ResultadoTecnica aplicarCandidatosBloqueados() {
+        int podadas = 0;
+        
+        for (int b = 0; b < TAMANO; b++) {
+            int filaInicio = (b / N) * N;
+            int colInicio = (b % N) * N;
+            Mascara porFila[N] = {}, porCol[N] = {};
+            
+            for (int i = 0; i < N; i++) {
+                for (int j = 0; j < N; j++) {
+                    int celda = (filaInicio + i) * TAMANO + colInicio + j;
+                    if (sudoku[celda] == 0) {
+                        porFila[i] |= candidatosCelda[celda];
+                        porCol[j] |= candidatosCelda[celda];
+                    }
+                }
+            }
+            
+            for (int i = 0; i < N; i++) {
+                Mascara otrasFilas = 0, otrasCols = 0;
+                for (int k = 0; k < N; k++) {
+                    if (k == i) continue;
+                    otrasFilas |= porFila[k];
+                    otrasCols |= porCol[k];
+                }
+                
+                Mascara soloFila = porFila[i] & ~otrasFilas;
+                if (soloFila != 0) {
+                    podadas += podarFueraDeSegmento(filaInicio + i, colInicio, soloFila);
+                }
+                
+                Mascara soloCol = porCol[i] & ~otrasCols;
+                if (soloCol != 0) {
+                    podadas += podarFueraDeSegmento(TAMANO + colInicio + i, filaInicio, soloCol);
+                }
+            }
+        }
+        
+        // Claiming sobre filas (u < TAMANO) y columnas (TAMANO <= u < 2*TAMANO)
+        for (int u = 0; u < 2 * TAMANO; u++) {
+            bool esFila = u < TAMANO;
+            int linea = esFila ? u : u - TAMANO;
+            Mascara porSegmento[N] = {};
+            
+            for (int k = 0; k < TAMANO; k++) {
+                int celda = tablas().unidades[u][k];
+                if (sudoku[celda] == 0) {
+                    porSegmento[k / N] |= candidatosCelda[celda];
+                }
+            }
+            
+            for (int seg = 0; seg < N; seg++) {
+                Mascara otros = 0;
+                for (int k = 0; k < N; k++) {
+                    if (k != seg) otros |= porSegmento[k];
+                }
+                
+                Mascara soloSegmento = porSegmento[seg] & ~otros;
+                if (soloSegmento == 0) continue;
+                
+                int bloque = esFila ? (linea / N) * N + seg : seg * N + linea / N;
+                int unidadBloque = 2 * TAMANO + bloque;
+                
+                for (int k = 0; k < TAMANO; k++) {
+                    int celda = tablas().unidades[unidadBloque][k];
+                    bool enLinea = esFila ? (celda / TAMANO == linea) : (celda % TAMANO == linea);
+                    if (!enLinea && sudoku[celda] == 0 && (candidatosCelda[celda] & soloSegmento)) {
+                        podarCandidatos(celda, soloSegmento);
+                        podadas++;
+                    }
+                }
+            }
+        }
+        
+        contadores.candidatosBloqueados += podadas;
+        return podadas > 0 ? CAMBIOS : SIN_CAMBIOS;
+    }
+    
+    /**
+     * Pares y tríos desnudos: k celdas de una unidad cuyos candidatos suman
+     * exactamente k valores; esos valores se podan del resto de la unidad
+     */
+    ResultadoTecnica aplicarSubconjuntosDesnudos() {
+        for (int u = 0; u < UNIDADES; u++) {
+            int celdas[TAMANO];
+            int total = 0;
+            
+            for (int k = 0; k < TAMANO; k++) {
+                int celda = tablas().unidades[u][k];
+                if (sudoku[celda] == 0 && contarBits(candidatosCelda[celda]) <= 3) {
+                    celdas[total++] = celda;
+                }
+            }
+            
+            for (int a = 0; a < total; a++) {
+                for (int b = a + 1; b < total; b++) {
+                    Mascara par = candidatosCelda[celdas[a]] | candidatosCelda[celdas[b]];
+                    int cuenta = contarBits(par);
+                    
+                    if (cuenta < 2) return CONTRADICCION;
+                    if (cuenta == 2) {
+                        int grupo[3] = {celdas[a], celdas[b], -1};
+                        if (podarResto(u, grupo, par)) return CAMBIOS;
+                    }
+                    // Con más de tres valores ningún trío que lo contenga sirve
+                    if (cuenta > 3) continue;
+                    
+                    for (int c = b + 1; c < total; c++) {
+                        Mascara trio = par | candidatosCelda[celdas[c]];
+                        cuenta = contarBits(trio);
+                        
+                        if (cuenta < 3) return CONTRADICCION;
+                        if (cuenta == 3) {
+                            int grupo[3] = {celdas[a], celdas[b], celdas[c]};
+                            if (podarResto(u, grupo, trio)) return CAMBIOS;
+                        }
+                    }
+                }
+            }
+        }
+        
+        return SIN_CAMBIOS;
+    }
+    
+    bool podarResto(int unidad, const int grupo[3], Mascara valores) {
+        int podadas = 0;
+        for (int k = 0; k < TAMANO; k++) {
+            int celda = tablas().unidades[unidad][k];
+            if (celda == grupo[0] || celda == grupo[1] || celda == grupo[2]) continue;
+            
+            if (sudoku[celda] == 0 && (candidatosCelda[celda] & valores)) {
+                podarCandidatos(celda, valores);
+                podadas++;
+            }
+        }
+        contadores.subconjuntosDesnudos += podadas;
+        return podadas > 0;
+    }
+    
+    /**
+     * Pares y tríos ocultos: k valores que solo caben en las mismas k celdas
+     * de una unidad; el resto de candidatos de esas celdas se poda
+     */
+    ResultadoTecnica aplicarSubconjuntosOcultos() {
+        for (int u = 0; u < UNIDADES; u++) {
+            // Posiciones (índice dentro de la unidad) donde cabe cada valor
+            Mascara posiciones[TAMANO + 1] = {};
+            int valores[TAMANO];
+            int total = 0;
+            
+            for (int k = 0; k < TAMANO; k++) {
+                int celda = tablas().unidades[u][k];
+                if (sudoku[celda] != 0) continue;
+                for (Mascara m = candidatosCelda[celda]; m != 0; m = quitarMenor(m)) {
+                    posiciones[valorMenor(m)] |= bitDeValor<Mascara>(k + 1);
+                }
+            }
+            
+            for (int v = 1; v <= TAMANO; v++) {
+                int cuenta = contarBits(posiciones[v]);
+                if (cuenta >= 2 && cuenta <= 3) {
+                    valores[total++] = v;
+                }
+            }
+            
+            for (int a = 0; a < total; a++) {
+                for (int b = a + 1; b < total; b++) {
+                    Mascara par = posiciones[valores[a]] | posiciones[valores[b]];
+                    Mascara grupoPar = bitDeValor<Mascara>(valores[a]) | bitDeValor<Mascara>(valores[b]);
+                    
+                    int cuenta = contarBits(par);
+                    if (cuenta == 2) {
+                        if (podarAjenos(u, par, grupoPar)) return CAMBIOS;
+                    }
+                    if (cuenta > 3) continue;
+                    
+                    for (int c = b + 1; c < total; c++) {
+                        Mascara trio = par | posiciones[valores[c]];
+                        
+                        // Tres valores encerrados en dos celdas
+                        if (contarBits(trio) < 3) return CONTRADICCION;
+                        if (contarBits(trio) == 3) {
+                            Mascara grupo = grupoPar | bitDeValor<Mascara>(valores[c]);
+                            if (podarAjenos(u, trio, grupo)) return CAMBIOS;
+                        }
+                    }
+                }
+            }
+        }
+        
+        return SIN_CAMBIOS;
+    }
+    
+    bool podarAjenos(int unidad, Mascara posiciones, Mascara grupo) {
+        int podadas = 0;
+        for (int k = 0; k < TAMANO; k++) {
+            if (!(posiciones & bitDeValor<Mascara>(k + 1))) continue;
+            
+            int celda = tablas().unidades[unidad][k];
+            Mascara ajenos = candidatosCelda[celda] & ~grupo;
+            if (ajenos != 0) {
+                podarCandidatos(celda, ajenos);
+                podadas++;
+            }
+        }
+        contadores.subconjuntosOcultos += podadas;
+        return podadas > 0;
+    }
+    
+    /**
+     * Propagación de restricciones: aplica las técnicas activas de la más
+     * barata a la más cara y vuelve a empezar tras cada cambio
+     */
+    bool propagarRestricciones() {
+        while (true) {
+            if (tamanoCubeta[0] > 0) {
+                return false;
+            }
+            
+            // Naked singles: celdas con un único candidato
+            if (tecnicas.singlesDesnudos && tamanoCubeta[1] > 0) {
+                int celda = cubetas[1][tamanoCubeta[1] - 1];
+                colocarValor(celda, valorMenor(candidatosCelda[celda]));
+                contadores.singlesDesnudos++;
+                continue;
+            }
+            
+            if (celdasVacias == 0) {
+                return true;
+            }
+            
+            ResultadoTecnica resultado = SIN_CAMBIOS;
+            
+            if (tecnicas.singlesOcultos) {
+                resultado = aplicarSinglesOcultos();
+            }
+            if (resultado == SIN_CAMBIOS && tecnicas.candidatosBloqueados) {
+                resultado = aplicarCandidatosBloqueados();
+            }
+            if (resultado == SIN_CAMBIOS && tecnicas.subconjuntosDesnudos) {
+                resultado = aplicarSubconjuntosDesnudos();
+            }
+            if (resultado == SIN_CAMBIOS && tecnicas.subconjuntosOcultos) {
+                resultado = aplicarSubconjuntosOcultos();
+            }
+            
+            if (resultado == CONTRADICCION) {
+                return false;
+            }
+            if (resultado == SIN_CAMBIOS) {
+                return true;
+            }
+        }
+    }
+    
+    /**
+     * Propagación con el tiempo acumulado en las estadísticas si están activas
+     */
+    bool propagarMidiendo() {
+        if constexpr (MEDIR) {
+            auto inicio = chrono::steady_clock::now();
+            bool resultado = propagarRestricciones();
+            estadisticas.segundosPropagacion += chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+            return resultado;
+        } else {
+            return propagarRestricciones();
+        }
+    }
+    
+    void registrarRamificacion(int celda) {
+        int opciones = contarBits(candidatosCelda[celda]);
+        estadisticas.ramificacion[min(opciones, (int)EstadisticasBusqueda::MAX_RAMIFICACION)]++;
+    }
+    
+    /**
+     * Llamada con el tablero completo. Sin modo conteo basta con parar; en
+     * modo conteo se anota la solución y solo se para al llegar al máximo.
+     */
+    bool registrarSolucion() {
+        if (maximoSoluciones == 0) {
+            return true;
+        }
+        if (solucionesEncontradas++ == 0) {
+            memcpy(primeraSolucion, sudoku, sizeof(sudoku));
+        }
+        long long total = solucionesGlobales ? ++*solucionesGlobales : solucionesEncontradas;
+        return total >= maximoSoluciones;
+    }
+    
+    /**
+     * MRV: la primera cubeta no vacía tiene las celdas con menos candidatos
+     */
+    int seleccionarCeldaMRV() {
+        int minCandidatos = 1;
+        while (minCandidatos <= TAMANO && tamanoCubeta[minCandidatos] == 0) {
+            minCandidatos++;
+        }
+        
+        if (minCandidatos > TAMANO) {
+            return -1;
+        }
+        
+        return cubetas[minCandidatos][0];
+    }
+    
+    /**
+     * Backtracking optimizado con MRV
+     *
+     * Las asignaciones hechas aquí (propagación incluida) quedan en el rastro;
+     * si el nodo falla, el llamador las deshace volviendo a su marca.
+     */
+    bool resolverBacktracking() {
+        nodosExplorados++;
+        
+        // Otro trabajador ya terminó o se agotó el presupuesto
+        if ((cancelacion && cancelacion->load(memory_order_relaxed)) ||
+            presupuesto.excedido(nodosExplorados)) {
+            return false;
+        }
+        
+        if (!propagarMidiendo()) {
+            return false;
+        }
+        
+        if (celdasVacias == 0) {
+            return registrarSolucion();
+        }
+        
+        int mejorCelda = seleccionarCeldaMRV();
+        if (mejorCelda == -1) {
+            return false;
+        }
+        
+        if constexpr (MEDIR) {
+            registrarRamificacion(mejorCelda);
+            profundidadActual++;
+            estadisticas.profundidadMaxima = max(estadisticas.profundidadMaxima, profundidadActual);
+        }
+        
+        // Probar cada candidato
+        for (Mascara m = candidatosCelda[mejorCelda]; m != 0; m = quitarMenor(m)) {
+            size_t marca = rastro.size();
+            
+            colocarValor(mejorCelda, valorMenor(m));
+            if constexpr (MEDIR) estadisticas.asignacionesRamificacion++;
+            
+            if (resolverBacktracking()) {
+                if constexpr (MEDIR) {
+                    // La máscara de la celda elegida no cambia mientras está asignada
+                    estadisticas.decisionesCamino++;
+                    estadisticas.bitsCamino += log2((double)contarBits(candidatosCelda[mejorCelda]));
+                }
+                return true;
+            }
+            
+            // Restaurar estado
+            deshacerHasta(marca);
+            if constexpr (MEDIR) estadisticas.retrocesos++;
+            
+            if (presupuesto.estaAgotado()) {
+                break;
+            }
+        }
+        
+        if constexpr (MEDIR) profundidadActual--;
+        return false;
+    }
+    
+    /**
+     * Reproduce el camino de una tarea y la procesa: por encima de la
+     * profundidad de división la expande en subtareas (una por candidato
+     * de la celda MRV); por debajo resuelve el subárbol completo.
+     * Deja el estado sin deshacer para poder leer la solución.
+     */
+    bool procesarTarea(const Tarea& tarea, ColaTrabajo& cola, atomic<int>& pendientes) {
+        for (size_t i = 0; i < tarea.camino.size(); i++) {
+            int celda = tarea.camino[i].first;
+            int valor = tarea.camino[i].second;
+            
+            // La propagación es sólida: si falla al reproducir, el subárbol no tiene solución
+            if (sudoku[celda] != 0 || !(candidatosCelda[celda] & bitDeValor<Mascara>(valor))) {
+                return false;
+            }
+            colocarValor(celda, valor);
+            
+            if (i + 1 < tarea.camino.size() && !propagarMidiendo()) {
+                return false;
+            }
+        }
+        
+        if ((int)tarea.camino.size() >= profundidadDivision) {
+            profundidadActual = (int)tarea.camino.size();
+            return resolverBacktracking();
+        }
+        
+        nodosExplorados++;
+        if (!propagarMidiendo()) {
+            return false;
+        }
+        if (celdasVacias == 0) {
+            return registrarSolucion();
+        }
+        
+        int celda = seleccionarCeldaMRV();
+        if (celda == -1) {
+            return false;
+        }
+        
+        if constexpr (MEDIR) {
+            registrarRamificacion(celda);
+            estadisticas.asignacionesRamificacion += contarBits(candidatosCelda[celda]);
+            estadisticas.profundidadMaxima = max(estadisticas.profundidadMaxima, (int)tarea.camino.size() + 1);
+        }
+        
+        // En orden inverso para que el dueño explore primero el menor candidato
+        lock_guard<mutex> lock(cola.mtx);
+        for (int v = TAMANO; v >= 1; v--) {
+            if (candidatosCelda[celda] & bitDeValor<Mascara>(v)) {
+                Tarea hija = tarea;
+                hija.camino.push_back(make_pair(celda, v));
+                pendientes++;
+                cola.tareas.push_back(move(hija));
+            }
+        }
+        
+        return false;
+    }
+    
+    static bool tomarTarea(vector<ColaTrabajo>& colas, int propia, Tarea& tarea) {
+        {
+            lock_guard<mutex> lock(colas[propia].mtx);
+            if (!colas[propia].tareas.empty()) {
+                tarea = move(colas[propia].tareas.back());
+                colas[propia].tareas.pop_back();
+                return true;
+            }
+        }
+        
+        // Robar de la cola de otro trabajador
+        for (size_t k = 1; k < colas.size(); k++) {
+            ColaTrabajo& victima = colas[(propia + k) % colas.size()];
+            lock_guard<mutex> lock(victima.mtx);
+            if (!victima.tareas.empty()) {
+                tarea = move(victima.tareas.front());
+                victima.tareas.pop_front();
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    /**
+     * Búsqueda con robo de trabajo: cada hilo trabaja sobre su copia del
+     * estado raíz; el primero que encuentra solución cancela al resto.
+     * En modo conteo cada copia cuenta en sus subárboles y se cancela al
+     * llegar entre todas al máximo. Los nodos, contadores y soluciones de
+     * todos los trabajadores se suman aquí.
+     */
+    bool resolverEnParalelo() {
+        nodosExplorados++;
+        if (!propagarMidiendo()) {
+            return false;
+        }
+        if (celdasVacias == 0) {
+            return registrarSolucion();
+        }
+        
+        // 'detener' corta a todos: la pone quien encuentra la solución o agota su presupuesto
+        atomic<bool> encontrada(false);
+        atomic<bool> detener(false);
+        atomic<long long> soluciones(0);
+        atomic<int> pendientes(1);
+        vector<ColaTrabajo> colas(hilosBusqueda);
+        colas[0].tareas.push_back(Tarea());
+        
+        // Las copias se hacen antes de lanzar hilos: el ganador escribe en *this
+        vector<unique_ptr<NucleoHibrido>> copias;
+        for (int h = 0; h < hilosBusqueda; h++) {
+            copias.emplace_back(new NucleoHibrido(*this));
+            copias[h]->cancelacion = &detener;
+            copias[h]->presupuesto.repartirNodos(hilosBusqueda);
+            copias[h]->nodosExplorados = 0;
+            copias[h]->solucionesEncontradas = 0;
+            copias[h]->solucionesGlobales = &soluciones;
+            copias[h]->contadores = ContadoresTecnicas();
+            copias[h]->estadisticas = EstadisticasBusqueda();
+        }
+        
+        auto trabajador = [&](int h) {
+            NucleoHibrido& copia = *copias[h];
+            Tarea tarea;
+            
+            while (!detener.load()) {
+                if (!tomarTarea(colas, h, tarea)) {
+                    if (pendientes.load() == 0) break;
+                    this_thread::yield();
+                    continue;
+                }
+                
+                size_t marca = copia.rastro.size();
+                if (copia.procesarTarea(tarea, colas[h], pendientes)) {
+                    bool esperado = false;
+                    if (encontrada.compare_exchange_strong(esperado, true)) {
+                        memcpy(sudoku, copia.sudoku, sizeof(sudoku));
+                    }
+                    detener = true;
+                } else if (copia.presupuesto.estaAgotado()) {
+                    detener = true;
+                }
+                copia.deshacerHasta(marca);
+                pendientes--;
+            }
+        };
+        
+        vector<thread> trabajadores;
+        for (int h = 0; h < hilosBusqueda; h++) {
+            trabajadores.emplace_back(trabajador, h);
+        }
+        for (auto& t : trabajadores) {
+            t.join();
+        }
+        
+        for (const auto& copia : copias) {
+            nodosExplorados += copia->nodosExplorados;
+            contadores.acumular(copia->contadores);
+            estadisticas.acumular(copia->estadisticas);
+            if (copia->presupuesto.estaAgotado()) {
+                presupuesto.marcarAgotado();
+            }
+            if (copia->solucionesEncontradas > 0 && solucionesEncontradas == 0) {
+                memcpy(primeraSolucion, copia->primeraSolucion, sizeof(primeraSolucion));
+            }
+            solucionesEncontradas += copia->solucionesEncontradas;
+        }
+        
+        // Varias copias pueden pasar del máximo a la vez antes de cancelarse
+        if (maximoSoluciones > 0) {
+            solucionesEncontradas = min(solucionesEncontradas, maximoSoluciones);
+        }
+        
+        if (encontrada.load()) {
+            celdasVacias = 0;
+            return true;
+        }
+        return false;
+    }
+    
+    bool validarEstadoInicial() {
+        return validarTableroPlano(sudoku, N) == TABLERO_VALIDO;
+    }
+    
+public:
+    NucleoHibrido() : nodosExplorados(0), celdasVacias(0), solucionesGlobales(nullptr), profundidadActual(0),
+                      hilosBusqueda(1), profundidadDivision(4), cancelacion(nullptr), tablasDinamicas(nullptr) {
+        memset(sudoku, 0, sizeof(sudoku));
+        if constexpr (GRANDE) {
+            tablasDinamicas = &TablasSudoku<N>::compartidas();
+        }
+    }
+    
+    void cargarSudoku(const int* tablero, int) override {
+        nodosExplorados = 0;
+        celdasVacias = 0;
+        rastro.clear();
+        contadores = ContadoresTecnicas();
+        estadisticas = EstadisticasBusqueda();
+        profundidadActual = 0;
+        memset(tamanoCubeta, 0, sizeof(tamanoCubeta));
+        
+        // Candidatos libres por fila, columna y bloque
+        Mascara filaLibres[TAMANO], colLibres[TAMANO], bloqueLibres[TAMANO];
+        for (int i = 0; i < TAMANO; i++) {
+            filaLibres[i] = colLibres[i] = bloqueLibres[i] = TODOS;
+        }
+        
+        // Cargar tablero (los valores fuera de rango los rechaza validarEstadoInicial)
+        for (int i = 0; i < TAMANO; i++) {
+            for (int j = 0; j < TAMANO; j++) {
+                int celda = i * TAMANO + j;
+                int valor = tablero[celda];
+                
+                if (valor < 0 || valor > TAMANO) {
+                    sudoku[celda] = TAMANO + 1;
+                } else {
+                    sudoku[celda] = valor;
+                }
+                
+                if (valor == 0) {
+                    celdasVacias++;
+                } else if (valor >= 1 && valor <= TAMANO) {
+                    Mascara bit = bitDeValor<Mascara>(valor);
+                    filaLibres[i] &= ~bit;
+                    colLibres[j] &= ~bit;
+                    bloqueLibres[(i / N) * N + j / N] &= ~bit;
+                }
+            }
+        }
+        
+        // Máscaras iniciales y cubetas de las celdas vacías
+        for (int celda = 0; celda < CELDAS; celda++) {
+            if (sudoku[celda] != 0) continue;
+            
+            int i = celda / TAMANO, j = celda % TAMANO;
+            candidatosCelda[celda] = filaLibres[i] & colLibres[j] & bloqueLibres[(i / N) * N + j / N];
+            insertarEnCubeta(celda, contarBits(candidatosCelda[celda]));
+        }
+    }
+    
+    bool resolverSudoku() override {
+        presupuesto.iniciar();
+        solucionesEncontradas = 0;
+        if (!validarEstadoInicial()) {
+            return false;
+        }
+        
+        bool resuelto;
+        if constexpr (MEDIR) {
+            auto inicio = chrono::steady_clock::now();
+            resuelto = hilosBusqueda > 1 ? resolverEnParalelo() : resolverBacktracking();
+            double total = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+            
+            // En paralelo la propagación se suma entre hilos: se acota al total
+            estadisticas.segundosPropagacion = min(estadisticas.segundosPropagacion, total);
+            estadisticas.segundosBusqueda = total - estadisticas.segundosPropagacion;
+        } else {
+            resuelto = hilosBusqueda > 1 ? resolverEnParalelo() : resolverBacktracking();
+        }
+        
+        if (maximoSoluciones == 0) {
+            solucionesEncontradas = resuelto;
+            return resuelto;
+        }
+        
+        // En modo conteo el tablero queda en la última solución vista
+        if (solucionesEncontradas > 0) {
+            memcpy(sudoku, primeraSolucion, sizeof(sudoku));
+        }
+        return solucionesEncontradas > 0;
+    }
+    
+    /**
+     * Solo la propagación de la raíz, sin ramificar: true si las técnicas
+     * activas resuelven el tablero. Los contadores quedan con los usos de
+     * cada técnica.
+     */
+    bool propagarSinRamificar() override {
+        presupuesto.iniciar();
+        solucionesEncontradas = 0;
+        if (!validarEstadoInicial()) {
+            return false;
+        }
+        
+        nodosExplorados = 1;
+        bool resuelto = propagarMidiendo() && celdasVacias == 0;
+        solucionesEncontradas = resuelto;
+        return resuelto;
+    }
+    
+    void copiarSolucion(int* destino) const override {
+        for (int celda = 0; celda < CELDAS; celda++) {
+            destino[celda] = sudoku[celda];
+        }
+    }
+    
+    long long obtenerNodosExplorados() const override {
+        return nodosExplorados;
+    }
+    
+    ContadoresTecnicas obtenerContadores() const override {
+        return contadores;
+    }
+    
+    EstadisticasBusqueda obtenerEstadisticas() const override {
+        EstadisticasBusqueda resultado = estadisticas;
+        resultado.asignacionesPropagacion = contadores.singlesDesnudos + contadores.singlesOcultos;
+        return resultado;
+    }
+    
+    void configurarTecnicas(const TecnicasPropagacion& activas) override {
+        tecnicas = activas;
+    }
+    
+    void configurarBusquedaParalela(int hilos, int profundidad) override {
+        hilosBusqueda = max(1, hilos);
+        profundidadDivision = max(1, profundidad);
+    }
+    
+    // Las tablas dinámicas se cuentan aunque las compartan todos los núcleos
+    size_t obtenerBytesMemoria() const override {
+        size_t bytes = sizeof(*this) + rastro.capacity() * sizeof(EntradaRastro);
+        if constexpr (GRANDE) {
+            bytes += sizeof(TablasSudoku<N>);
+            for (const Cubeta& cubeta : cubetas) {
+                bytes += cubeta.capacity() * sizeof(int16_t);
+            }
+        }
+        return bytes;
+    }
+};
+
+/**
+ * Resolvedor híbrido: propagación avanzada + backtracking optimizado.
+ * Delega en el núcleo especializado para el orden de bloque del sudoku
+ * (n = 2..10); el núcleo se reutiliza mientras no cambie el tamaño.
+ */
+class ResolvedorSudokuHibrido : public ResolvedorSudoku {
+private:
+    unique_ptr<NucleoHibridoBase> nucleo;
+    int n;
+    TecnicasPropagacion tecnicas;
+    int hilosBusqueda;
+    int profundidadDivision;
+    bool conEstadisticas;
+    
+    template <bool MEDIR>
+    static unique_ptr<NucleoHibridoBase> crearNucleo(int n) {
+        switch (n) {
+            case 2: return unique_ptr<NucleoHibridoBase>(new NucleoHibrido<2, MEDIR>());
+            case 3: return unique_ptr<NucleoHibridoBase>(new NucleoHibrido<3, MEDIR>());
+            case 4: return unique_ptr<NucleoHibridoBase>(new NucleoHibrido<4, MEDIR>());
+            case 5: return unique_ptr<NucleoHibridoBase>(new NucleoHibrido<5, MEDIR>());
+            case 6: return unique_ptr<NucleoHibridoBase>(new NucleoHibrido<6, MEDIR>());
+            case 7: return unique_ptr<NucleoHibridoBase>(new NucleoHibrido<7, MEDIR>());
+            case 8: return unique_ptr<NucleoHibridoBase>(new NucleoHibrido<8, MEDIR>());
+            case 9: return unique_ptr<NucleoHibridoBase>(new NucleoHibrido<9, MEDIR>());
+            case 10: return unique_ptr<NucleoHibridoBase>(new NucleoHibrido<10, MEDIR>());
+            default: return nullptr;
+        }
+    }
+    
+public:
+    ResolvedorSudokuHibrido() : n(0), hilosBusqueda(1), profundidadDivision(4), conEstadisticas(false) {}
+    
+    void cargarSudoku(const int* tablero, int nParam) override {
+        if (!nucleo || nParam != n) {
+            n = nParam;
+            nucleo = conEstadisticas ? crearNucleo<true>(n) : crearNucleo<false>(n);
+            if (nucleo) {
+                nucleo->configurarTecnicas(tecnicas);
+                nucleo->configurarBusquedaParalela(hilosBusqueda, profundidadDivision);
+                nucleo->configurarLimites(presupuesto.obtenerLimites());
+                nucleo->configurarConteo(maximoSoluciones);
+            }
+        }
+        
+        if (nucleo) {
+            nucleo->cargarSudoku(tablero, n);
+        }
+    }
+    
+    bool resolverSudoku() override {
+        return nucleo && nucleo->resolverSudoku();
+    }
+    
+    /**
+     * Aplica las técnicas de propagación a la raíz sin ramificar; true si
+     * bastan para resolver el sudoku cargado
+     */
+    bool propagarSinRamificar() {
+        return nucleo && nucleo->propagarSinRamificar();
+    }
+    
+    void copiarSolucion(int* destino) const override {
+        if (nucleo) {
+            nucleo->copiarSolucion(destino);
+        }
+    }
+    
+    long long obtenerNodosExplorados() const override {
+        return nucleo ? nucleo->obtenerNodosExplorados() : 0;
+    }
+    
+    ContadoresTecnicas obtenerContadores() const override {
+        return nucleo ? nucleo->obtenerContadores() : ContadoresTecnicas();
+    }
+    
+    EstadisticasBusqueda obtenerEstadisticas() const override {
+        return nucleo ? nucleo->obtenerEstadisticas() : EstadisticasBusqueda();
+    }
+    
+    void configurarLimites(const LimitesBusqueda& limites) override {
+        presupuesto.configurar(limites);
+        if (nucleo) nucleo->configurarLimites(limites);
+    }
+    
+    bool limiteAgotado() const override {
+        return nucleo && nucleo->limiteAgotado();
+    }
+    
+    void configurarConteo(long long maximo) override {
+        ResolvedorSudoku::configurarConteo(maximo);
+        if (nucleo) nucleo->configurarConteo(maximoSoluciones);
+    }
+    
+    long long obtenerSoluciones() const override {
+        return nucleo ? nucleo->obtenerSoluciones() : 0;
+    }
+    
+    size_t obtenerBytesMemoria() const override {
+        return nucleo ? nucleo->obtenerBytesMemoria() : 0;
+    }
+    
+    void configurarTecnicas(const TecnicasPropagacion& activas) {
+        tecnicas = activas;
+        if (nucleo) nucleo->configurarTecnicas(tecnicas);
+    }
+    
+    /**
+     * Hilos para repartir la búsqueda de un sudoku y profundidad (en
+     * decisiones MRV) hasta la que se divide el árbol en tareas
+     */
+    void configurarBusquedaParalela(int hilos, int profundidad = 4) {
+        hilosBusqueda = max(1, hilos);
+        profundidadDivision = max(1, profundidad);
+        if (nucleo) nucleo->configurarBusquedaParalela(hilosBusqueda, profundidadDivision);
+    }
+    
+    /**
+     * Activa las estadísticas de búsqueda; el núcleo se recrea con la
+     * variante instrumentada en la siguiente carga
+     */
+    void configurarEstadisticas(bool activas) {
+        if (activas != conEstadisticas) {
+            conEstadisticas = activas;
+            nucleo.reset();
+        }
+    }
+};
+
+/**
+ * Resolvedor por cobertura exacta: Algorithm X sobre Dancing Links
+ *
+ * Columnas (4 * tamano²): celda ocupada, valor en fila, valor en columna
+ * y valor en bloque. Filas (tamano³): cada terna (fila, col, valor).
+ * En cada nodo se elige la columna con menos filas activas.
+ */
+class ResolvedorSudokuDLX : public ResolvedorSudoku {
+private:
+    // Matriz dispersa en arreglos paralelos; el nodo 0 es la raíz y
+    // los nodos 1..numColumnas son las cabeceras de columna
+    vector<int> izq, der, arr, aba;
+    vector<int> columnaDe, filaDe;
+    vector<int> tamanoColumna;
+    vector<int> filasSolucion;
+    vector<int> primeraSolucion;    // filas de la primera solución en modo conteo
+    vector<int> sudoku;  // plano, por filas
+    int n, tamano;
+    int numColumnas;
+    long long nodosExplorados;
+    bool estadoInicialValido;
+    
+    int crearNodo(int columna, int fila) {
+        int nodo = izq.size();
+        izq.push_back(nodo);
+        der.push_back(nodo);
+        arr.push_back(arr[columna]);
+        aba.push_back(columna);
+        columnaDe.push_back(columna);
+        filaDe.push_back(fila);
+        
+        aba[arr[columna]] = nodo;
+        arr[columna] = nodo;
+        tamanoColumna[columna]++;
+        return nodo;
+    }
+    
+    void cubrir(int c) {
+        der[izq[c]] = der[c];
+        izq[der[c]] = izq[c];
+        for (int i = aba[c]; i != c; i = aba[i]) {
+            for (int j = der[i]; j != i; j = der[j]) {
+                aba[arr[j]] = aba[j];
+                arr[aba[j]] = arr[j];
+                tamanoColumna[columnaDe[j]]--;
+            }
+        }
+    }
+    
+    void descubrir(int c) {
+        for (int i = arr[c]; i != c; i = arr[i]) {
+            for (int j = izq[i]; j != i; j = izq[j]) {
+                tamanoColumna[columnaDe[j]]++;
+                aba[arr[j]] = j;
+                arr[aba[j]] = j;
+            }
+        }
+        der[izq[c]] = c;
+        izq[der[c]] = c;
+    }
+    
+    void construirMatriz() {
+        int celdas = tamano * tamano;
+        numColumnas = 4 * celdas;
+        
+        izq.clear(); der.clear(); arr.clear(); aba.clear();
+        columnaDe.clear(); filaDe.clear();
+        tamanoColumna.assign(numColumnas + 1, 0);
+        
+        size_t totalNodos = numColumnas + 1 + 4 * (size_t)celdas * tamano;
+        izq.reserve(totalNodos); der.reserve(totalNodos);
+        arr.reserve(totalNodos); aba.reserve(totalNodos);
+        columnaDe.reserve(totalNodos); filaDe.reserve(totalNodos);
+        
+        // Raíz y cabeceras enlazadas en anillo horizontal
+        for (int c = 0; c <= numColumnas; c++) {
+            izq.push_back(c == 0 ? numColumnas : c - 1);
+            der.push_back(c == numColumnas ? 0 : c + 1);
+            arr.push_back(c);
+            aba.push_back(c);
+            columnaDe.push_back(c);
+            filaDe.push_back(-1);
+        }
+        
+        for (int f = 0; f < tamano; f++) {
+            for (int c = 0; c < tamano; c++) {
+                int bloque = (f / n) * n + (c / n);
+                for (int v = 0; v < tamano; v++) {
+                    int fila = (f * tamano + c) * tamano + v;
+                    int columnas[4] = {
+                        1 + f * tamano + c,
+                        1 + celdas + f * tamano + v,
+                        1 + 2 * celdas + c * tamano + v,
+                        1 + 3 * celdas + bloque * tamano + v
+                    };
+                    
+                    int primero = -1;
+                    for (int k = 0; k < 4; k++) {
+                        int nodo = crearNodo(columnas[k], fila);
+                        if (primero == -1) {
+                            primero = nodo;
+                        } else {
+                            izq[nodo] = izq[primero];
+                            der[nodo] = primero;
+                            der[izq[primero]] = nodo;
+                            izq[primero] = nodo;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    
+    /**
+     * Fija una fila de la matriz (pista inicial). Falla si alguna de sus
+     * columnas ya fue cubierta por otra pista.
+     */
+    bool seleccionarFila(int fila) {
+        // Los nodos de la fila se crearon consecutivos tras las cabeceras
+        int nodo = numColumnas + 1 + 4 * fila;
+        int j = nodo;
+        do {
+            int c = columnaDe[j];
+            if (der[izq[c]] != c) {
+                return false;
+            }
+            j = der[j];
+        } while (j != nodo);
+        
+        j = nodo;
+        do {
+            cubrir(columnaDe[j]);
+            j = der[j];
+        } while (j != nodo);
+        
+        filasSolucion.push_back(fila);
+        return true;
+    }
+    
+    bool buscar() {
+        nodosExplorados++;
+        
+        if (der[0] == 0) {
+            if (maximoSoluciones == 0) {
+                return true;
+            }
+            if (solucionesEncontradas++ == 0) {
+                primeraSolucion = filasSolucion;
+            }
+            return solucionesEncontradas >= maximoSoluciones;
+        }
+        
+        if (presupuesto.excedido(nodosExplorados)) {
+            return false;
+        }
+        
+        // Heurística de columna: la de menor tamaño
+        int mejor = der[0];
+        for (int c = der[mejor]; c != 0; c = der[c]) {
+            if (tamanoColumna[c] < tamanoColumna[mejor]) {
+                mejor = c;
+                if (tamanoColumna[c] <= 1) break;
+            }
+        }
+        
+        if (tamanoColumna[mejor] == 0) {
+            return false;
+        }
+        
+        cubrir(mejor);
+        
+        for (int r = aba[mejor]; r != mejor; r = aba[r]) {
+            filasSolucion.push_back(filaDe[r]);
+            for (int j = der[r]; j != r; j = der[j]) {
+                cubrir(columnaDe[j]);
+            }
+            
+            if (buscar()) {
+                return true;
+            }
+            
+            for (int j = izq[r]; j != r; j = izq[j]) {
+                descubrir(columnaDe[j]);
+            }
+            filasSolucion.pop_back();
+            
+            if (presupuesto.estaAgotado()) {
+                break;
+            }
+        }
+        
+        descubrir(mejor);
+        return false;
+    }
+    
+public:
+    ResolvedorSudokuDLX() : n(0), tamano(0), numColumnas(0), nodosExplorados(0), estadoInicialValido(false) {}
+    
+    void cargarSudoku(const int* tablero, int nParam) override {
+        n = nParam;
+        tamano = n * n;
+        nodosExplorados = 0;
+        filasSolucion.clear();
+        sudoku.assign(tablero, tablero + tamano * tamano);
+        estadoInicialValido = true;
+        
+        construirMatriz();
+        
+        for (int i = 0; i < tamano && estadoInicialValido; i++) {
+            for (int j = 0; j < tamano; j++) {
+                int valor = tablero[i * tamano + j];
+                if (valor == 0) continue;
+                
+                if (valor < 1 || valor > tamano ||
+                    !seleccionarFila((i * tamano + j) * tamano + valor - 1)) {
+                    estadoInicialValido = false;
+                    break;
+                }
+            }
+        }
+    }
+    
+    bool resolverSudoku() override {
+        presupuesto.iniciar();
+        solucionesEncontradas = 0;
+        if (!estadoInicialValido) {
+            return false;
+        }
+        
+        bool resuelto = buscar();
+        if (maximoSoluciones == 0) {
+            solucionesEncontradas = resuelto;
+        } else {
+            resuelto = solucionesEncontradas > 0;
+            filasSolucion = primeraSolucion;
+        }
+        
+        if (!resuelto) {
+            return false;
+        }
+        
+        for (int fila : filasSolucion) {
+            int v = fila % tamano;
+            int celda = fila / tamano;
+            sudoku[celda] = v + 1;
+        }
+        
+        return true;
+    }
+    
+    void copiarSolucion(int* destino) const override {
+        copy(sudoku.begin(), sudoku.end(), destino);
+    }
+    
+    long long obtenerNodosExplorados() const override {
+        return nodosExplorados;
+    }
+    
+    size_t obtenerBytesMemoria() const override {
+        size_t enteros = izq.capacity() + der.capacity() + arr.capacity() + aba.capacity() +
+                         columnaDe.capacity() + filaDe.capacity() + tamanoColumna.capacity() +
+                         filasSolucion.capacity() + primeraSolucion.capacity() + sudoku.capacity();
+        return sizeof(*this) + enteros * sizeof(int);
+    }
+};
+
+/**
+ * Crea el motor de resolución indicado por nombre ("hibrido" o "dlx")
+ */
+inline unique_ptr<ResolvedorSudoku> crearResolvedor(const string& motor,
+                                                    const TecnicasPropagacion& tecnicas = TecnicasPropagacion(),
+                                                    int hilosBusqueda = 1,
+                                                    bool estadisticas = false,
+                                                    const LimitesBusqueda& limites = LimitesBusqueda()) {
+    if (motor == "hibrido") {
+        ResolvedorSudokuHibrido* hibrido = new ResolvedorSudokuHibrido();
+        hibrido->configurarTecnicas(tecnicas);
+        hibrido->configurarBusquedaParalela(hilosBusqueda);
+        hibrido->configurarEstadisticas(estadisticas);
+        hibrido->configurarLimites(limites);
+        return unique_ptr<ResolvedorSudoku>(hibrido);
+    }
+    if (motor == "dlx") {
+        ResolvedorSudokuDLX* dlx = new ResolvedorSudokuDLX();
+        dlx->configurarLimites(limites);
+        return unique_ptr<ResolvedorSudoku>(dlx);
+    }
+    throw runtime_error("Motor desconocido: " + motor);
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef PROTOCOLO_SERVIDOR_H
+#define PROTOCOLO_SERVIDOR_H
+
+#ifdef _WIN32
+#error "El servidor y su cliente usan sockets Unix: compilar en Linux o macOS"
+#endif
+
+#include <string>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "FormatoBinario.h"
+
+using namespace std;
+
+/**
+ * Protocolo del servidor de sudokus sobre un socket Unix de flujo. Una
+ * conexión puede enviar muchas peticiones sin esperar las respuestas;
+ * las respuestas llegan en el orden de las peticiones.
+ *
+ * Texto (por defecto): las peticiones son bloques etiquetados como los de
+ * los archivos de entrada. Cada bloque recibe una respuesta: el bloque
+ * resuelto (o "Sin solucion" / "Tiempo agotado" / "Dimensiones
+ * invalidas") seguido de una línea vacía. Un bloque termina al completar
+ * sus filas, al llegar otra etiqueta o al cerrar el cliente su envío. Si
+ * quedan más de 1 MB sin formar un bloque, se cierra la conexión.
+ *
+ * Binario: la conexión empieza con la firma "SDKB" de FormatoBinario.h.
+ *   Petición:  uint8 n, celdas empaquetadas (bytesCeldas(n) bytes)
+ *   Respuesta: uint8 estado (EstadoRespuesta), y si es RESPUESTA_RESUELTO
+ *              la solución empaquetada igual que la petición
+ *   Un n fuera de 2..10 cierra la conexión.
+ */
+enum EstadoRespuesta {
+    RESPUESTA_RESUELTO = 0,
+    RESPUESTA_SIN_SOLUCION = 1,
+    RESPUESTA_TIEMPO_AGOTADO = 2,
+    RESPUESTA_INVALIDA = 3    // valores fuera de rango o dimensiones inválidas
+};
+
+static const char* const RUTA_SOCKET_POR_DEFECTO = "/tmp/sudoku.sock";
+
+inline sockaddr_un direccionUnix(const string& ruta) {
+    sockaddr_un direccion;
+    memset(&direccion, 0, sizeof(direccion));
+    direccion.sun_family = AF_UNIX;
+    if (ruta.size() >= sizeof(direccion.sun_path)) {
+        throw runtime_error("Ruta de socket demasiado larga: " + ruta);
+    }
+    memcpy(direccion.sun_path, ruta.c_str(), ruta.size() + 1);
+    return direccion;
+}
+
+inline int conectarSocket(const string& ruta) {
+    sockaddr_un direccion = direccionUnix(ruta);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (sockaddr*)&direccion, sizeof(direccion)) != 0) {
+        if (fd >= 0) close(fd);
+        throw runtime_error("No se pudo conectar a: " + ruta + " (" + strerror(errno) + ")");
+    }
+    return fd;
+}
+
+/**
+ * Envía todo el búfer; false si el otro extremo cerró
+ */
+inline bool enviarTodo(int fd, const char* datos, size_t largo) {
+    while (largo > 0) {
+#ifdef MSG_NOSIGNAL
+        ssize_t enviados = send(fd, datos, largo, MSG_NOSIGNAL);
+#else
+        ssize_t enviados = send(fd, datos, largo, 0);
+#endif
+        if (enviados < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        datos += enviados;
+        largo -= (size_t)enviados;
+    }
+    return true;
+}
+
+inline void anadirPeticionBinaria(string& destino, const int* celdas, int n) {
+    destino.push_back((char)n);
+    empaquetarCeldas(celdas, n, destino);
+}
+
+inline size_t largoRespuestaBinaria(int estado, int n) {
+    return 1 + (estado == RESPUESTA_RESUELTO ? bytesCeldas(n) : 0);
+}
+
+#endif
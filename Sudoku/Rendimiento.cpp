@@ -0,0 +1,370 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+
+#include "MotoresSudoku.h"
+#include "LectorSudokus.h"
+#include "ValidadorBits.h"
+#include "GeneradorSudokus.h"
+#include "UtilidadesJson.h"
+
+using namespace std;
+using namespace chrono;
+
+/**
+ * Sudoku de un corpus, ya decodificado a tablero plano
+ */
+struct MuestraCorpus {
+    string etiqueta;
+    int n;
+    vector<int> celdas;
+};
+
+/**
+ * Resultado de una fase medida sobre un corpus. Los campos que no
+ * aplican a la fase quedan en cero y no se informan.
+ */
+struct MedicionFase {
+    string corpus;
+    string fase;
+    string motor;
+    long long elementos = 0;
+    long long resueltos = 0;
+    long long nodos = 0;
+    double nsPorElemento = 0;
+    double p50 = 0;
+    double p99 = 0;
+    double nodosPorSegundo = 0;
+    double megabytesPorSegundo = 0;
+    size_t memoriaBytes = 0;    // mayor estado del motor al resolver
+};
+
+/**
+ * Banco de pruebas de rendimiento: mide lectura, resolución y validación
+ * sobre corpus etiquetados, y la generación de sudokus de solución
+ * única, para detectar regresiones entre versiones
+ */
+class BancoPruebas {
+private:
+    vector<string> motores;
+    int repeticiones = 3;
+    bool salidaJson = false;
+
+    static double percentil(vector<double>& muestras, double fraccion) {
+        if (muestras.empty()) return 0;
+        size_t k = (size_t)(fraccion * (muestras.size() - 1) + 0.5);
+        nth_element(muestras.begin(), muestras.begin() + k, muestras.end());
+        return muestras[k];
+    }
+
+    /**
+     * Lee el corpus 'repeticiones' veces y se queda con la mejor
+     */
+    MedicionFase medirLectura(const string& ruta, vector<MuestraCorpus>& corpus) {
+        MedicionFase medicion;
+        medicion.corpus = ruta;
+        medicion.fase = "lectura";
+
+        double mejor = 1e300;
+        for (int r = 0; r < repeticiones; r++) {
+            LectorSudokus lector;
+            vector<MuestraCorpus> leidos;
+
+            auto inicio = steady_clock::now();
+            lector.leerArchivoPlano(ruta, [&](const TableroPlano& sudoku) {
+                if (sudoku.tamano == 0) return;
+                MuestraCorpus muestra;
+                muestra.etiqueta = string(sudoku.etiqueta);
+                muestra.n = sudoku.n;
+                muestra.celdas.assign(sudoku.celdas, sudoku.celdas + sudoku.tamano * sudoku.tamano);
+                leidos.push_back(move(muestra));
+            });
+            auto fin = steady_clock::now();
+
+            double segundos = duration<double>(fin - inicio).count();
+            if (segundos < mejor) {
+                mejor = segundos;
+                medicion.megabytesPorSegundo = lector.obtenerBytesLeidos() / (1024.0 * 1024.0) / max(segundos, 1e-9);
+            }
+            corpus = move(leidos);
+        }
+
+        medicion.elementos = corpus.size();
+        medicion.nsPorElemento = corpus.empty() ? 0 : mejor * 1e9 / corpus.size();
+        return medicion;
+    }
+
+    /**
+     * Carga y resuelve cada sudoku del corpus; cada resolución es una
+     * muestra de latencia. Guarda las soluciones para medir la validación.
+     */
+    MedicionFase medirResolucion(const string& ruta, const vector<MuestraCorpus>& corpus,
+                                 const string& motor, vector<MuestraCorpus>& soluciones) {
+        MedicionFase medicion;
+        medicion.corpus = ruta;
+        medicion.fase = "resolver";
+        medicion.motor = motor;
+
+        unique_ptr<ResolvedorSudoku> resolvedor = crearResolvedor(motor);
+        vector<double> latencias;
+        latencias.reserve(corpus.size() * repeticiones);
+        double segundosTotales = 0;
+        soluciones.clear();
+
+        // Una pasada sin medir para calentar cachés y reservar memoria
+        for (const auto& muestra : corpus) {
+            resolvedor->cargarSudoku(muestra.celdas.data(), muestra.n);
+            resolvedor->resolverSudoku();
+        }
+
+        for (int r = 0; r < repeticiones; r++) {
+            for (const auto& muestra : corpus) {
+                auto inicio = steady_clock::now();
+                resolvedor->cargarSudoku(muestra.celdas.data(), muestra.n);
+                bool resuelto = resolvedor->resolverSudoku();
+                auto fin = steady_clock::now();
+
+                double segundos = duration<double>(fin - inicio).count();
+                latencias.push_back(segundos * 1e9);
+                segundosTotales += segundos;
+                medicion.nodos += resolvedor->obtenerNodosExplorados();
+                medicion.memoriaBytes = max(medicion.memoriaBytes, resolvedor->obtenerBytesMemoria());
+
+                if (r == 0 && resuelto) {
+                    medicion.resueltos++;
+                    MuestraCorpus solucion = muestra;
+                    resolvedor->copiarSolucion(solucion.celdas.data());
+                    soluciones.push_back(move(solucion));
+                }
+            }
+        }
+
+        medicion.elementos = corpus.size();
+        if (!latencias.empty()) {
+            medicion.nsPorElemento = segundosTotales * 1e9 / latencias.size();
+            medicion.p50 = percentil(latencias, 0.50);
+            medicion.p99 = percentil(latencias, 0.99);
+        }
+        medicion.nodosPorSegundo = segundosTotales > 0 ? medicion.nodos / segundosTotales : 0;
+        return medicion;
+    }
+
+    MedicionFase medirValidacion(const string& ruta, const vector<MuestraCorpus>& soluciones) {
+        MedicionFase medicion;
+        medicion.corpus = ruta;
+        medicion.fase = "validar";
+        medicion.elementos = soluciones.size();
+        if (soluciones.empty()) return medicion;
+
+        // Cada tablero es muy barato: se repite hasta acumular tiempo medible
+        int vueltas = max(1, (int)(200000 / soluciones.size())) * repeticiones;
+        long long validos = 0;
+
+        auto inicioTotal = steady_clock::now();
+        for (int v = 0; v < vueltas; v++) {
+            for (const auto& solucion : soluciones) {
+                validos += validarTableroPlano(solucion.celdas.data(), solucion.n) == TABLERO_VALIDO;
+            }
+        }
+        auto finTotal = steady_clock::now();
+
+        medicion.resueltos = validos / vueltas;
+        medicion.nsPorElemento = duration<double, nano>(finTotal - inicioTotal).count() / ((double)vueltas * soluciones.size());
+        return medicion;
+    }
+
+    /**
+     * Genera 'cantidad' sudokus con semillas fijas (siempre los mismos);
+     * cada sudoku es una muestra de latencia
+     */
+    MedicionFase medirGeneracion(int n, int cantidad) {
+        MedicionFase medicion;
+        int tamano = n * n;
+        medicion.corpus = "generados " + to_string(tamano) + "x" + to_string(tamano);
+        medicion.fase = "generar";
+
+        GeneradorSudokus generador(n);
+        vector<int> sudoku;
+        vector<double> latencias;
+        double segundosTotales = 0;
+
+        for (int r = 0; r < repeticiones; r++) {
+            for (int i = 0; i < cantidad; i++) {
+                auto inicio = steady_clock::now();
+                generador.generar(i, sudoku);
+                auto fin = steady_clock::now();
+
+                double segundos = duration<double>(fin - inicio).count();
+                latencias.push_back(segundos * 1e9);
+                segundosTotales += segundos;
+            }
+        }
+
+        medicion.elementos = cantidad;
+        medicion.resueltos = cantidad;
+        if (!latencias.empty()) {
+            medicion.nsPorElemento = segundosTotales * 1e9 / latencias.size();
+            medicion.p50 = percentil(latencias, 0.50);
+            medicion.p99 = percentil(latencias, 0.99);
+        }
+        return medicion;
+    }
+
+    void informar(const MedicionFase& m) {
+        if (salidaJson) {
+            cout << "{\"corpus\":\"" << escaparJson(m.corpus) << "\",\"fase\":\"" << m.fase << "\"";
+            if (!m.motor.empty()) cout << ",\"motor\":\"" << m.motor << "\"";
+            cout << ",\"elementos\":" << m.elementos;
+            cout << fixed << setprecision(1);
+            if (m.fase == "lectura") {
+                cout << ",\"mb_s\":" << m.megabytesPorSegundo;
+            } else {
+                cout << ",\"correctos\":" << m.resueltos;
+            }
+            cout << ",\"ns_por_elemento\":" << m.nsPorElemento;
+            if (m.fase == "resolver" || m.fase == "generar") {
+                cout << ",\"p50_ns\":" << m.p50 << ",\"p99_ns\":" << m.p99;
+            }
+            if (m.fase == "resolver") {
+                cout << ",\"nodos\":" << m.nodos << ",\"nodos_s\":" << m.nodosPorSegundo
+                     << ",\"memoria_kb\":" << m.memoriaBytes / 1024.0;
+            }
+            cout << "}" << endl;
+            cout.unsetf(ios::fixed);
+            return;
+        }
+
+        cout << "  " << left << setw(9) << m.fase << setw(9) << m.motor << right
+             << setw(6) << m.elementos << fixed << setprecision(0)
+             << setw(14) << m.nsPorElemento << " ns";
+        if (m.fase == "lectura") {
+            cout << setprecision(1) << setw(12) << m.megabytesPorSegundo << " MB/s";
+        } else if (m.fase == "resolver") {
+            cout << "  p50 " << setw(10) << m.p50 << "  p99 " << setw(10) << m.p99
+                 << "  " << setw(12) << m.nodosPorSegundo << " nodos/s"
+                 << setw(10) << m.memoriaBytes / 1024 << " KB  ok " << m.resueltos;
+        } else if (m.fase == "generar") {
+            cout << "  p50 " << setw(10) << m.p50 << "  p99 " << setw(10) << m.p99
+                 << "  " << setw(12) << 1e9 / max(m.nsPorElemento, 1.0) << " sudokus/s";
+        } else {
+            cout << "  ok " << m.resueltos;
+        }
+        cout << endl;
+        cout.unsetf(ios::fixed);
+    }
+
+public:
+    BancoPruebas() : motores({ "hibrido", "dlx" }) {}
+
+    void establecerMotores(const vector<string>& lista) {
+        motores = lista;
+    }
+
+    void establecerRepeticiones(int cantidad) {
+        repeticiones = max(1, cantidad);
+    }
+
+    void establecerJson(bool activo) {
+        salidaJson = activo;
+    }
+
+    void medirCorpus(const string& ruta) {
+        if (!salidaJson) {
+            cout << ruta << endl;
+        }
+
+        vector<MuestraCorpus> corpus;
+        informar(medirLectura(ruta, corpus));
+
+        vector<MuestraCorpus> soluciones;
+        for (const auto& motor : motores) {
+            vector<MuestraCorpus> solucionesMotor;
+            informar(medirResolucion(ruta, corpus, motor, solucionesMotor));
+            if (soluciones.empty()) {
+                soluciones = move(solucionesMotor);
+            }
+        }
+
+        informar(medirValidacion(ruta, soluciones));
+
+        if (!salidaJson) {
+            cout << endl;
+        }
+    }
+
+    void medirGeneracionEn(int n, int cantidad) {
+        MedicionFase medicion = medirGeneracion(n, cantidad);
+        if (!salidaJson) {
+            cout << medicion.corpus << endl;
+        }
+        informar(medicion);
+        if (!salidaJson) {
+            cout << endl;
+        }
+    }
+};
+
+/**
+ * Uso: rendimiento [--motor hibrido|dlx|todos] [--repeticiones N] [--generar N] [--json] [corpus...]
+ *
+ * Sin corpus se usan los de bench/ y sudokus_entrada.txt (ejecutar desde Sudoku/).
+ * --generar fija cuántos 9x9 se generan (0 = no medir la generación).
+ */
+int main(int argc, char* argv[]) {
+    try {
+        BancoPruebas banco;
+        vector<string> corpus;
+        bool json = false;
+        int generados = 300;
+
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--motor" && i + 1 < argc) {
+                string motor = argv[++i];
+                if (motor == "todos") {
+                    banco.establecerMotores({ "hibrido", "dlx" });
+                } else {
+                    crearResolvedor(motor);
+                    banco.establecerMotores({ motor });
+                }
+            } else if (arg == "--repeticiones" && i + 1 < argc) {
+                banco.establecerRepeticiones(stoi(argv[++i]));
+            } else if (arg == "--generar" && i + 1 < argc) {
+                generados = stoi(argv[++i]);
+            } else if (arg == "--json") {
+                json = true;
+            } else {
+                corpus.push_back(arg);
+            }
+        }
+
+        if (corpus.empty()) {
+            corpus = { "bench/faciles_9x9.txt", "bench/dificiles_9x9.txt",
+                       "bench/16x16.txt", "bench/25x25.txt", "bench/36x36.txt",
+                       "bench/49x49.txt", "bench/64x64.txt", "sudokus_entrada.txt" };
+        }
+
+        banco.establecerJson(json);
+        if (!json) {
+            cout << "=== RENDIMIENTO N-SUDOKU ===" << endl << endl;
+        }
+
+        for (const auto& ruta : corpus) {
+            banco.medirCorpus(ruta);
+        }
+
+        if (generados > 0) {
+            banco.medirGeneracionEn(3, generados);
+        }
+
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
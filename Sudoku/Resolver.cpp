@@ -1,522 +1,661 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include <bitset>
 #include <string>
 #include <cmath>
 #include <iomanip>
 #include <algorithm>
 #include <chrono>
 #include <cstring>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+#include "MotoresSudoku.h"
+#include "LectorSudokus.h"
+#include "EscritorSudokus.h"
+#include "FormatoBinario.h"
+#include "CanonizadorSudokus.h"
+#include "CachePersistente.h"
+#include "ColasConcurrentes.h"
+#include "UtilidadesJson.h"
 
 using namespace std;
 using namespace chrono;
 
-struct SudokuConEtiqueta {
-    string etiqueta;
-    vector<vector<int>> tablero;
-    int n;
-    int tamano;
-};
-
-/**
- * Resolvedor híbrido: propagación avanzada + backtracking optimizado
- */
-class ResolvedorSudokuHibrido {
+class ProcesadorMultipleSudoku {
 private:
-    int sudoku[25][25];
-    bitset<26> filaCandidatos[25];
-    bitset<26> colCandidatos[25];
-    bitset<26> bloqueCandidatos[25];
-    int n, tamano;
-    long long nodosExplorados;
-    int celdasVacias;
+    // El tablero de entrada se sobrescribe con la solución
+    struct TareaSudoku {
+        size_t indice = 0;
+        string etiqueta;
+        int n = 0;
+        vector<int> celdas;
+        ResultadoSudoku resultado;
+    };
     
-    int obtenerBloque(int fila, int col) {
-        return (fila / n) * n + (col / n);
-    }
-    
-    bitset<26> obtenerCandidatos(int fila, int col) {
-        int bloque = obtenerBloque(fila, col);
-        return filaCandidatos[fila] & colCandidatos[col] & bloqueCandidatos[bloque];
-    }
+    string motor = "hibrido";
+    TecnicasPropagacion tecnicas;
+    int hilos = 1;
+    int hilosBusqueda = 1;
+    size_t capacidadCola = 0;   // 0 = automática según los hilos
+    bool salidaBinaria = false;
+    string archivoEstadisticas;  // vacío = sin estadísticas por sudoku
+    LimitesBusqueda limites;
+    string motorReintento;       // vacío = sin reintento al agotar el límite
+    long long maximoSoluciones = 0;  // modo conteo; 0 = parar en la primera
+    bool conCache = false;           // caché de soluciones por forma canónica
+    string rutaCacheDisco;           // vacío = sin caché en disco
+    uint64_t maximoCacheDisco = 256ULL << 20;
     
-    void colocarValor(int fila, int col, int valor) {
-        sudoku[fila][col] = valor;
-        int bloque = obtenerBloque(fila, col);
-        filaCandidatos[fila].reset(valor);
-        colCandidatos[col].reset(valor);
-        bloqueCandidatos[bloque].reset(valor);
-    }
-    
-    void quitarValor(int fila, int col, int valor) {
-        sudoku[fila][col] = 0;
-        int bloque = obtenerBloque(fila, col);
-        filaCandidatos[fila].set(valor);
-        colCandidatos[col].set(valor);
-        bloqueCandidatos[bloque].set(valor);
+    /**
+     * Texto del conteo de soluciones para la consola; si se llegó al
+     * máximo o se agotó el límite el conteo es solo una cota inferior
+     */
+    string describirSoluciones(long long soluciones, bool agotado) const {
+        if (agotado || soluciones >= maximoSoluciones) {
+            return "al menos " + to_string(soluciones) + (soluciones == 1 ? " solucion" : " soluciones");
+        }
+        if (soluciones == 1) {
+            return "solucion unica";
+        }
+        return to_string(soluciones) + " soluciones";
     }
     
     /**
-     * Propagación de restricciones (solo para sudokus grandes)
+     * Una línea JSON con las métricas de un sudoku resuelto
      */
-    bool propagarRestricciones() {
-        if (tamano <= 9) return true; // Skip para sudokus pequeños
-        
-        bool cambios = true;
-        int iteraciones = 0;
-        
-        while (cambios && iteraciones < 10) {
-            cambios = false;
-            iteraciones++;
-            
-            // Naked Singles
-            for (int i = 0; i < tamano; i++) {
-                for (int j = 0; j < tamano; j++) {
-                    if (sudoku[i][j] == 0) {
-                        bitset<26> candidatos = obtenerCandidatos(i, j);
-                        int numCandidatos = candidatos.count();
-                        
-                        if (numCandidatos == 0) {
-                            return false;
-                        }
-                        
-                        if (numCandidatos == 1) {
-                            for (int v = 1; v <= tamano; v++) {
-                                if (candidatos[v]) {
-                                    colocarValor(i, j, v);
-                                    celdasVacias--;
-                                    cambios = true;
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
+    void escribirEstadisticas(ostream& out, const TareaSudoku& tarea) {
+        const ResultadoSudoku& r = tarea.resultado;
+        const EstadisticasBusqueda& e = r.estadisticas;
+        const ContadoresTecnicas& c = r.contadores;
+        
+        // El histograma se corta tras la última entrada no nula
+        int ultima = EstadisticasBusqueda::MAX_RAMIFICACION;
+        while (ultima > 0 && e.ramificacion[ultima] == 0) ultima--;
+        
+        const char* estado = r.agotado ? "tiempo_agotado" : (r.resuelto ? "resuelto" : "sin_solucion");
+        
+        out << "{\"etiqueta\":\"" << escaparJson(tarea.etiqueta) << "\""
+            << ",\"n\":" << tarea.n
+            << ",\"motor\":\"" << (r.reintentado ? motorReintento : motor) << "\""
+            << ",\"reintento\":" << (r.reintentado ? "true" : "false")
+            << ",\"cache\":" << (r.deCache ? "true" : "false")
+            << ",\"resuelto\":" << (r.resuelto ? "true" : "false")
+            << ",\"estado\":\"" << estado << "\""
+            << ",\"soluciones\":" << r.soluciones
+            << ",\"segundos\":" << r.segundos
+            << ",\"nodos\":" << r.nodos
+            << ",\"retrocesos\":" << e.retrocesos
+            << ",\"profundidad_maxima\":" << e.profundidadMaxima
+            << ",\"asignaciones_propagacion\":" << e.asignacionesPropagacion
+            << ",\"asignaciones_ramificacion\":" << e.asignacionesRamificacion
+            << ",\"ramificacion\":[";
+        for (int k = 0; k <= ultima; k++) {
+            out << (k > 0 ? "," : "") << e.ramificacion[k];
         }
-        
-        return true;
+        out << "],\"segundos_propagacion\":" << e.segundosPropagacion
+            << ",\"segundos_busqueda\":" << e.segundosBusqueda
+            << ",\"tecnicas\":{\"singles_desnudos\":" << c.singlesDesnudos
+            << ",\"singles_ocultos\":" << c.singlesOcultos
+            << ",\"bloqueados\":" << c.candidatosBloqueados
+            << ",\"subconjuntos_desnudos\":" << c.subconjuntosDesnudos
+            << ",\"subconjuntos_ocultos\":" << c.subconjuntosOcultos
+            << "}}\n";
     }
     
+public:
     /**
-     * Backtracking optimizado con MRV
+     * Procesa el archivo en tres etapas concurrentes unidas por colas
+     * acotadas: lectura, resolución con 'hilos' trabajadores (cada uno
+     * con su propio resolvedor) y escritura en el orden de entrada. La
+     * memoria no depende del tamaño del archivo y las primeras
+     * soluciones se escriben mientras se sigue leyendo.
+     *
+     * Devuelve la cantidad de sudokus procesados.
      */
-    bool resolverBacktracking() {
-        nodosExplorados++;
+    size_t procesarArchivo(const string& archivoEntrada, const string& archivoSalida) {
+        unique_ptr<EscritorSudokus> escritor;
+        if (salidaBinaria) {
+            escritor.reset(new EscritorBinario(archivoSalida));
+        } else {
+            escritor.reset(new EscritorTexto(archivoSalida));
+        }
         
-        // Propagar restricciones periódicamente para sudokus grandes
-        if (tamano > 16 && nodosExplorados % 100 == 0) {
-            if (!propagarRestricciones()) {
-                return false;
+        ofstream estadisticas;
+        if (!archivoEstadisticas.empty()) {
+            estadisticas.open(archivoEstadisticas);
+            if (!estadisticas.is_open()) {
+                throw runtime_error("No se pudo crear archivo: " + archivoEstadisticas);
             }
+            estadisticas << setprecision(9);
         }
-        
-        if (celdasVacias == 0) {
-            return true;
+        bool conEstadisticas = estadisticas.is_open();
+        
+        size_t capacidad = capacidadCola > 0 ? capacidadCola : 16 * (size_t)hilos;
+        ColaAcotada<TareaSudoku> pendientes(capacidad);
+        VentanaOrdenada<TareaSudoku> resueltos(capacidad + hilos);
+        // Tareas ya escritas que la lectura reutiliza junto con sus búferes
+        ColaAcotada<TareaSudoku> recicladas(2 * capacidad + hilos);
+        vector<ContadoresTecnicas> contadoresPorHilo(hilos);
+        
+        // La caché no se usa en modo conteo: guarda una sola solución
+        unique_ptr<CacheSoluciones> cache;
+        if (conCache && maximoSoluciones == 0) {
+            cache.reset(new CacheSoluciones());
+        }
+        unique_ptr<CachePersistente> cacheDisco;
+        if (!rutaCacheDisco.empty() && maximoSoluciones == 0) {
+            cacheDisco.reset(new CachePersistente(rutaCacheDisco, maximoCacheDisco));
         }
         
-        // MRV: Encontrar celda con menos candidatos
-        int mejorFila = -1, mejorCol = -1;
-        int minCandidatos = tamano + 1;
+        // Se crean aquí para que un motor desconocido falle antes de lanzar hilos
+        vector<unique_ptr<ResolvedorSudoku>> resolvedores;
+        vector<unique_ptr<ResolvedorSudoku>> reintentos;
+        for (int h = 0; h < hilos; h++) {
+            resolvedores.push_back(crearResolvedor(motor, tecnicas, hilosBusqueda, conEstadisticas, limites));
+            resolvedores.back()->configurarConteo(maximoSoluciones);
+            if (!motorReintento.empty()) {
+                reintentos.push_back(crearResolvedor(motorReintento, tecnicas, hilosBusqueda, conEstadisticas, limites));
+                reintentos.back()->configurarConteo(maximoSoluciones);
+            }
+        }
         
-        for (int i = 0; i < tamano; i++) {
-            for (int j = 0; j < tamano; j++) {
-                if (sudoku[i][j] == 0) {
-                    int numCandidatos = obtenerCandidatos(i, j).count();
+        // Etapa 1: lectura
+        exception_ptr errorLectura;
+        size_t bytesLeidos = 0;
+        double segundosLectura = 0;
+        thread lectura([&]() {
+            try {
+                LectorSudokus lector;
+                size_t indice = 0;
+                auto inicio = high_resolution_clock::now();
+                lector.leerArchivoPlano(archivoEntrada, [&](const TableroPlano& sudoku) {
+                    // Los bloques sin tablero no son entradas para el resolvedor
+                    if (sudoku.tamano == 0) return;
+                    
+                    if (sudoku.tamano > 100) {
+                        cerr << "Advertencia: " << sudoku.etiqueta << " excede tamaño maximo" << endl;
+                        return;
+                    }
                     
-                    if (numCandidatos == 0) {
-                        return false;
+                    TareaSudoku tarea;
+                    recicladas.intentarSacar(tarea);
+                    tarea.indice = indice++;
+                    tarea.etiqueta.assign(sudoku.etiqueta.data(), sudoku.etiqueta.size());
+                    tarea.n = sudoku.n;
+                    tarea.celdas.assign(sudoku.celdas, sudoku.celdas + sudoku.tamano * sudoku.tamano);
+                    tarea.resultado = ResultadoSudoku();
+                    pendientes.poner(move(tarea));
+                });
+                auto fin = high_resolution_clock::now();
+                segundosLectura = duration<double>(fin - inicio).count();
+                bytesLeidos = lector.obtenerBytesLeidos();
+            } catch (...) {
+                errorLectura = current_exception();
+            }
+            pendientes.cerrar();
+        });
+        
+        // Un error en cualquier etapa cierra las colas para que las demás
+        // terminen; se relanza después de unir todos los hilos
+        atomic<bool> cancelado(false);
+        auto cancelar = [&]() {
+            cancelado = true;
+            pendientes.cerrar();
+            resueltos.cerrar();
+        };
+        
+        // Etapa 2: resolución
+        atomic<int> trabajadoresActivos(hilos);
+        vector<exception_ptr> erroresTrabajo(hilos);
+        auto trabajador = [&](int h) {
+            TareaSudoku tarea;
+            CanonizadorSudokus canonizador;
+            TransformacionSudoku transformacion;
+            string clave, solucionCanonica;
+            vector<int> pistas;
+            
+            try {
+                while (!cancelado && pendientes.sacar(tarea)) {
+                    ResultadoSudoku& resultado = tarea.resultado;
+                
+                    // Un acierto se devuelve al marco del sudoku con la inversa
+                    // de su transformación canónica, sin buscar
+                    bool canonizado = false;
+                    if (cache) {
+                        auto inicio = high_resolution_clock::now();
+                        canonizado = canonizador.canonizar(tarea.celdas.data(), tarea.n, clave, transformacion);
+                        if (canonizado && cache->buscar(clave, solucionCanonica)) {
+                            resultado.deCache = true;
+                            resultado.resuelto = !solucionCanonica.empty();
+                            resultado.soluciones = resultado.resuelto;
+                            if (resultado.resuelto) {
+                                transformacion.deshacer(solucionCanonica, tarea.celdas.data());
+                            }
+                        }
+                        resultado.segundos += duration<double>(high_resolution_clock::now() - inicio).count();
+                    }
+                
+                    // La caché en disco se consulta con el tablero tal como llegó;
+                    // las pistas se conservan para guardar el resultado después
+                    if (cacheDisco && !resultado.deCache) {
+                        auto inicio = high_resolution_clock::now();
+                        pistas.assign(tarea.celdas.begin(), tarea.celdas.end());
+                        bool resuelto = false;
+                        if (cacheDisco->buscar(pistas.data(), tarea.n, resuelto, tarea.celdas.data())) {
+                            resultado.deCache = true;
+                            resultado.resuelto = resuelto;
+                            resultado.soluciones = resuelto;
+                        }
+                        resultado.segundos += duration<double>(high_resolution_clock::now() - inicio).count();
                     }
+                
+                    // Si el primer motor agota el límite, el de reintento empieza
+                    // de cero; tiempo y nodos se suman y las estadísticas son
+                    // las del último intento
+                    for (int intento = 0; intento < 2 && !resultado.deCache; intento++) {
+                        if (intento == 1 && (!resultado.agotado || reintentos.empty())) break;
+                        ResolvedorSudoku& resolvedor = intento == 0 ? *resolvedores[h] : *reintentos[h];
                     
-                    if (numCandidatos < minCandidatos) {
-                        minCandidatos = numCandidatos;
-                        mejorFila = i;
-                        mejorCol = j;
-                        
-                        if (minCandidatos == 1) {
-                            goto encontrado;
+                        resolvedor.cargarSudoku(tarea.celdas.data(), tarea.n);
+                    
+                        auto inicio = high_resolution_clock::now();
+                        resultado.resuelto = resolvedor.resolverSudoku();
+                        auto fin = high_resolution_clock::now();
+                    
+                        resultado.soluciones = resolvedor.obtenerSoluciones();
+                        // En modo conteo también se agota si el conteo quedó sin decidir
+                        resultado.agotado = resolvedor.limiteAgotado() &&
+                                            (maximoSoluciones > 0 ? resultado.soluciones < maximoSoluciones : !resultado.resuelto);
+                        resultado.reintentado = intento == 1;
+                        resultado.segundos += duration<double>(fin - inicio).count();
+                        resultado.nodos += resolvedor.obtenerNodosExplorados();
+                        if (resultado.resuelto) {
+                            resolvedor.copiarSolucion(tarea.celdas.data());
+                        }
+                        contadoresPorHilo[h].acumular(resolvedor.obtenerContadores());
+                        if (conEstadisticas) {
+                            resultado.contadores = resolvedor.obtenerContadores();
+                            resultado.estadisticas = resolvedor.obtenerEstadisticas();
+                        }
+                    }
+                
+                    if (canonizado && !resultado.deCache && !resultado.agotado) {
+                        solucionCanonica.clear();
+                        if (resultado.resuelto) {
+                            transformacion.aplicar(tarea.celdas.data(), solucionCanonica);
                         }
+                        cache->guardar(clave, solucionCanonica);
                     }
+                    if (cacheDisco && !resultado.deCache && !resultado.agotado) {
+                        cacheDisco->guardar(pistas.data(), tarea.n, resultado.resuelto, tarea.celdas.data());
+                    }
+                
+                    size_t indice = tarea.indice;
+                    resueltos.poner(indice, move(tarea));
                 }
+            } catch (...) {
+                erroresTrabajo[h] = current_exception();
+                cancelar();
             }
-        }
-        
-        encontrado:
+            
+            if (--trabajadoresActivos == 0) {
+                resueltos.cerrar();
+            }
+        };
         
-        if (mejorFila == -1) {
-            return celdasVacias == 0;
+        vector<thread> trabajadores;
+        for (int h = 0; h < hilos; h++) {
+            trabajadores.emplace_back(trabajador, h);
         }
         
-        bitset<26> candidatos = obtenerCandidatos(mejorFila, mejorCol);
-        
-        // Probar cada candidato
-        for (int v = 1; v <= tamano; v++) {
-            if (candidatos[v]) {
-                // Guardar estado
-                bitset<26> filaBackup = filaCandidatos[mejorFila];
-                bitset<26> colBackup = colCandidatos[mejorCol];
-                int bloque = obtenerBloque(mejorFila, mejorCol);
-                bitset<26> bloqueBackup = bloqueCandidatos[bloque];
-                
-                colocarValor(mejorFila, mejorCol, v);
-                celdasVacias--;
-                
-                if (resolverBacktracking()) {
-                    return true;
+        // Etapa 3: escritura en orden
+        size_t escritos = 0;
+        size_t agotados = 0;
+        size_t reintentados = 0;
+        size_t unicos = 0;
+        size_t multiples = 0;
+        exception_ptr errorEscritura;
+        TareaSudoku tarea;
+        try {
+            while (resueltos.sacar(tarea)) {
+                const auto& resultado = tarea.resultado;
+                int tamano = tarea.n * tarea.n;
+            
+                cout << "Resolviendo: " << tarea.etiqueta << " (" 
+                     << tamano << "x" << tamano << ") ... ";
+            
+                reintentados += resultado.reintentado;
+                string conteo;
+                if (maximoSoluciones > 0 && resultado.resuelto) {
+                    conteo = ", " + describirSoluciones(resultado.soluciones, resultado.agotado);
                 }
-                
-                // Restaurar estado
-                quitarValor(mejorFila, mejorCol, v);
-                filaCandidatos[mejorFila] = filaBackup;
-                colCandidatos[mejorCol] = colBackup;
-                bloqueCandidatos[bloque] = bloqueBackup;
-                celdasVacias++;
+            
+                // Un conteo agotado conserva la solución que haya encontrado
+                if (resultado.agotado) {
+                    cout << "Tiempo agotado (" << fixed << setprecision(3) << resultado.segundos * 1000.0 << " ms, "
+                         << resultado.nodos << " nodos" << conteo << ")" << endl;
+                    if (resultado.resuelto) {
+                        escritor->escribir(tarea.etiqueta, tarea.celdas.data(), tarea.n);
+                    } else {
+                        escritor->escribirSinTablero(tarea.etiqueta, MOTIVO_TIEMPO_AGOTADO);
+                    }
+                    agotados++;
+                } else if (resultado.resuelto) {
+                    cout << "Resuelto (" << fixed << setprecision(3) << resultado.segundos * 1000.0 << " ms, " 
+                         << resultado.nodos << " nodos" << conteo << (resultado.reintentado ? ", reintento" : "")
+                         << (resultado.deCache ? ", cache" : "") << ")" << endl;
+                    escritor->escribir(tarea.etiqueta, tarea.celdas.data(), tarea.n);
+                    unicos += resultado.soluciones == 1;
+                    multiples += resultado.soluciones > 1;
+                } else {
+                    cout << "Sin solucion" << (resultado.deCache ? " (cache)" : "") << endl;
+                    escritor->escribirSinTablero(tarea.etiqueta);
+                }
+            
+                if (conEstadisticas) {
+                    escribirEstadisticas(estadisticas, tarea);
+                }
+            
+                escritos++;
+                recicladas.intentarPoner(tarea);
             }
+        } catch (...) {
+            errorEscritura = current_exception();
+            cancelar();
         }
         
-        return false;
-    }
-    
-public:
-    ResolvedorSudokuHibrido() : nodosExplorados(0), celdasVacias(0) {
-        memset(sudoku, 0, sizeof(sudoku));
-    }
-    
-    void cargarSudoku(const vector<vector<int>>& tablero, int nParam) {
-        n = nParam;
-        tamano = n * n;
-        nodosExplorados = 0;
-        celdasVacias = 0;
-        
-        // Inicializar bitsets
-        for (int i = 0; i < 25; i++) {
-            filaCandidatos[i].reset();
-            colCandidatos[i].reset();
-            bloqueCandidatos[i].reset();
+        lectura.join();
+        for (auto& t : trabajadores) {
+            t.join();
         }
         
-        for (int i = 0; i < tamano; i++) {
-            for (int v = 1; v <= tamano; v++) {
-                filaCandidatos[i].set(v);
-                colCandidatos[i].set(v);
-                bloqueCandidatos[i].set(v);
-            }
+        if (errorEscritura) {
+            rethrow_exception(errorEscritura);
+        }
+        for (auto& e : erroresTrabajo) {
+            if (e) rethrow_exception(e);
         }
         
-        memset(sudoku, 0, sizeof(sudoku));
+        escritor->cerrar();
+        if (conEstadisticas) {
+            estadisticas.close();
+        }
         
-        // Cargar tablero
-        for (int i = 0; i < tamano; i++) {
-            for (int j = 0; j < tamano; j++) {
-                sudoku[i][j] = tablero[i][j];
-                
-                if (tablero[i][j] == 0) {
-                    celdasVacias++;
-                } else {
-                    int valor = tablero[i][j];
-                    int bloque = obtenerBloque(i, j);
-                    filaCandidatos[i].reset(valor);
-                    colCandidatos[j].reset(valor);
-                    bloqueCandidatos[bloque].reset(valor);
-                }
-            }
+        if (errorLectura) {
+            rethrow_exception(errorLectura);
         }
-    }
-    
-    bool validarEstadoInicial() {
-        // Verificar filas
-        for (int i = 0; i < tamano; i++) {
-            bitset<26> vistos;
-            for (int j = 0; j < tamano; j++) {
-                int valor = sudoku[i][j];
-                if (valor != 0) {
-                    if (valor < 1 || valor > tamano) return false;
-                    if (vistos[valor]) return false;
-                    vistos[valor] = 1;
-                }
+        
+        double megabytes = bytesLeidos / (1024.0 * 1024.0);
+        cout << "\nLectura: " << fixed << setprecision(2) << megabytes << " MB en "
+             << setprecision(3) << segundosLectura << " s ("
+             << setprecision(1) << (segundosLectura > 0 ? megabytes / segundosLectura : 0.0) << " MB/s)" << endl;
+        cout.unsetf(ios::fixed);
+        
+        if (motor == "hibrido") {
+            ContadoresTecnicas totales;
+            for (const auto& c : contadoresPorHilo) {
+                totales.acumular(c);
             }
+            
+            cout << "\nPropagacion: " << totales.singlesDesnudos << " singles desnudos, "
+                 << totales.singlesOcultos << " singles ocultos, "
+                 << totales.candidatosBloqueados << " podas por bloqueo, "
+                 << totales.subconjuntosDesnudos << " podas por subconjuntos desnudos, "
+                 << totales.subconjuntosOcultos << " podas por subconjuntos ocultos" << endl;
         }
         
-        // Verificar columnas
-        for (int j = 0; j < tamano; j++) {
-            bitset<26> vistos;
-            for (int i = 0; i < tamano; i++) {
-                int valor = sudoku[i][j];
-                if (valor != 0) {
-                    if (vistos[valor]) return false;
-                    vistos[valor] = 1;
-                }
-            }
+        if (maximoSoluciones > 1) {
+            cout << "\nUnicidad: " << unicos << " con solucion unica, "
+                 << multiples << " con varias soluciones" << endl;
         }
         
-        // Verificar bloques
-        for (int b = 0; b < tamano; b++) {
-            bitset<26> vistos;
-            int filaInicio = (b / n) * n;
-            int colInicio = (b % n) * n;
-            
-            for (int i = 0; i < n; i++) {
-                for (int j = 0; j < n; j++) {
-                    int valor = sudoku[filaInicio + i][colInicio + j];
-                    if (valor != 0) {
-                        if (vistos[valor]) return false;
-                        vistos[valor] = 1;
-                    }
-                }
-            }
+        if (cache) {
+            cout << "\nCache: " << cache->obtenerAciertos() << " aciertos en "
+                 << cache->obtenerConsultas() << " consultas, "
+                 << cache->obtenerEntradas() << " formas canonicas guardadas" << endl;
         }
         
-        return true;
-    }
-    
-    bool resolverSudoku() {
-        if (!validarEstadoInicial()) {
-            return false;
+        if (cacheDisco) {
+            cout << "\nCache en disco: " << cacheDisco->obtenerAciertos() << " aciertos en "
+                 << cacheDisco->obtenerConsultas() << " consultas, "
+                 << cacheDisco->obtenerEntradas() << " sudokus en " << rutaCacheDisco << " ("
+                 << fixed << setprecision(2) << cacheDisco->obtenerBytes() / (1024.0 * 1024.0) << " MB";
+            cout.unsetf(ios::fixed);
+            if (cacheDisco->obtenerCompactaciones() > 0) {
+                cout << ", " << cacheDisco->obtenerCompactaciones() << " compactaciones";
+            }
+            cout << ")" << endl;
         }
         
-        // Aplicar propagación inicial para sudokus grandes
-        if (tamano > 16) {
-            if (!propagarRestricciones()) {
-                return false;
+        if (limites.segundos > 0 || limites.nodos > 0) {
+            cout << "\nTiempo agotado: " << agotados << " sudokus";
+            if (!motorReintento.empty()) {
+                cout << " (" << reintentados << " reintentados con " << motorReintento << ")";
             }
+            cout << endl;
+        }
+        
+        if (escritos > 0) {
+            cout << "\nSoluciones guardadas en: " << archivoSalida << endl;
         }
         
-        return resolverBacktracking();
+        return escritos;
     }
     
-    vector<vector<int>> obtenerSolucion() const {
-        vector<vector<int>> resultado(tamano, vector<int>(tamano));
-        for (int i = 0; i < tamano; i++) {
-            for (int j = 0; j < tamano; j++) {
-                resultado[i][j] = sudoku[i][j];
-            }
-        }
-        return resultado;
+    void establecerMotor(const string& nombre) {
+        motor = nombre;
     }
     
-    long long obtenerNodosExplorados() const {
-        return nodosExplorados;
+    void establecerTecnicas(const TecnicasPropagacion& activas) {
+        tecnicas = activas;
     }
-};
-
-class ProcesadorMultipleSudoku {
-private:
-    vector<SudokuConEtiqueta> sudokus;
     
-    string trim(const string& str) {
-        size_t first = str.find_first_not_of(" \t\r\n");
-        if (first == string::npos) return "";
-        size_t last = str.find_last_not_of(" \t\r\n");
-        return str.substr(first, last - first + 1);
+    void establecerHilos(int cantidad) {
+        hilos = max(1, cantidad);
     }
     
-    vector<int> parsearLinea(const string& linea, int anchoSimbolo) {
-        vector<int> fila;
-        
-        for (size_t i = 0; i < linea.length(); i += anchoSimbolo) {
-            string simbolo = linea.substr(i, anchoSimbolo);
-            
-            bool esVacio = false;
-            for (char c : simbolo) {
-                if (c == '-') {
-                    esVacio = true;
-                    break;
-                }
-            }
-            
-            if (esVacio) {
-                fila.push_back(0);
-            } else {
-                try {
-                    int valor = stoi(simbolo);
-                    fila.push_back(valor);
-                } catch (...) {
-                    fila.push_back(0);
-                }
-            }
-        }
-        
-        return fila;
+    void establecerHilosBusqueda(int cantidad) {
+        hilosBusqueda = max(1, cantidad);
     }
     
-public:
-    void leerArchivo(const string& archivo) {
-        ifstream file(archivo);
-        if (!file.is_open()) {
-            throw runtime_error("No se pudo abrir el archivo: " + archivo);
-        }
-        
-        string linea;
-        string etiquetaActual = "";
-        vector<string> lineasSudoku;
-        int lineasEsperadas = -1;
-        
-        while (getline(file, linea)) {
-            linea = trim(linea);
-            
-            // Verificar si es una etiqueta
-            if (linea.find("Sudoku") != string::npos || 
-                linea.find("sudoku") != string::npos ||
-                (linea.length() > 0 && linea.back() == '#')) {
-                
-                // Procesar sudoku anterior si existe
-                if (!lineasSudoku.empty() && !etiquetaActual.empty()) {
-                    procesarSudoku(etiquetaActual, lineasSudoku);
-                    lineasSudoku.clear();
-                }
-                
-                etiquetaActual = linea;
-                lineasEsperadas = -1;
-            }
-            else if (!linea.empty() && !etiquetaActual.empty()) {
-                lineasSudoku.push_back(linea);
-                
-                // Determinar tamaño esperado
-                if (lineasEsperadas == -1) {
-                    for (int n = 2; n <= 10; n++) {
-                        int t = n * n;
-                        int ancho = floor(log10(t) + 1);
-                        if (linea.length() == t * ancho) {
-                            lineasEsperadas = t;
-                            break;
-                        }
-                    }
-                }
-                
-                // Procesar cuando tengamos todas las líneas
-                if (lineasEsperadas > 0 && lineasSudoku.size() == lineasEsperadas) {
-                    procesarSudoku(etiquetaActual, lineasSudoku);
-                    lineasSudoku.clear();
-                    etiquetaActual = "";
-                    lineasEsperadas = -1;
-                }
-            }
-        }
-        
-        // Procesar último sudoku
-        if (!lineasSudoku.empty() && !etiquetaActual.empty()) {
-            procesarSudoku(etiquetaActual, lineasSudoku);
-        }
-        
-        file.close();
+    void establecerCapacidadCola(size_t capacidad) {
+        capacidadCola = capacidad;
     }
     
-    void procesarSudoku(const string& etiqueta, const vector<string>& lineas) {
-        if (lineas.empty()) return;
-        
-        SudokuConEtiqueta sudoku;
-        sudoku.etiqueta = etiqueta;
-        sudoku.tamano = lineas.size();
-        sudoku.n = sqrt(sudoku.tamano);
-        
-        if (sudoku.n * sudoku.n != sudoku.tamano) {
-            cerr << "Advertencia: " << etiqueta << " dimensiones invalidas" << endl;
-            return;
-        }
-        
-        if (sudoku.tamano > 25) {
-            cerr << "Advertencia: " << etiqueta << " excede tamaño maximo" << endl;
-            return;
-        }
-        
-        int anchoSimbolo = floor(log10(sudoku.tamano) + 1);
-        
-        sudoku.tablero.resize(sudoku.tamano);
-        for (int i = 0; i < sudoku.tamano; i++) {
-            sudoku.tablero[i] = parsearLinea(lineas[i], anchoSimbolo);
-        }
-        
-        sudokus.push_back(sudoku);
+    void establecerSalidaBinaria(bool activa) {
+        salidaBinaria = activa;
     }
     
-    void resolverTodos(const string& archivoSalida) {
-        ofstream file(archivoSalida);
-        if (!file.is_open()) {
-            throw runtime_error("No se pudo crear archivo: " + archivoSalida);
-        }
-        
-        ResolvedorSudokuHibrido resolvedor;
-        
-        for (size_t idx = 0; idx < sudokus.size(); idx++) {
-            auto& sudoku = sudokus[idx];
-            
-            cout << "Resolviendo: " << sudoku.etiqueta << " (" 
-                 << sudoku.tamano << "x" << sudoku.tamano << ") ... " << flush;
-            
-            file << sudoku.etiqueta << endl;
-            
-            resolvedor.cargarSudoku(sudoku.tablero, sudoku.n);
-            
-            auto inicio = high_resolution_clock::now();
-            bool resuelto = resolvedor.resolverSudoku();
-            auto fin = high_resolution_clock::now();
-            auto duracion = duration_cast<milliseconds>(fin - inicio);
-            
-            if (resuelto) {
-                cout << "Resuelto (" << duracion.count() / 1000.0 << "s, " 
-                     << resolvedor.obtenerNodosExplorados() << " nodos)" << endl;
-                
-                escribirSudoku(file, resolvedor.obtenerSolucion(), sudoku.n);
-            } else {
-                cout << "Sin solucion" << endl;
-                file << "Sin solucion" << endl;
-            }
-            
-            if (idx < sudokus.size() - 1) {
-                file << endl;
-            }
-        }
-        
-        file.close();
-        cout << "\nSoluciones guardadas en: " << archivoSalida << endl;
+    /**
+     * Escribe una línea JSON por sudoku con las estadísticas de búsqueda
+     */
+    void establecerArchivoEstadisticas(const string& archivo) {
+        archivoEstadisticas = archivo;
     }
     
-    void escribirSudoku(ofstream& file, const vector<vector<int>>& tablero, int n) {
-        int tamano = n * n;
-        int anchoSimbolo = floor(log10(tamano) + 1);
-        
-        for (int i = 0; i < tamano; i++) {
-            for (int j = 0; j < tamano; j++) {
-                if (tablero[i][j] == 0) {
-                    file << string(anchoSimbolo, '-');
-                } else {
-                    file << setfill('0') << setw(anchoSimbolo) << tablero[i][j];
-                }
-            }
-            file << endl;
-        }
+    /**
+     * Límites por sudoku; al agotarlos se informa "Tiempo agotado"
+     */
+    void establecerLimites(const LimitesBusqueda& nuevos) {
+        limites = nuevos;
+    }
+    
+    /**
+     * Motor con el que se reintentan los sudokus que agotan el límite
+     */
+    void establecerMotorReintento(const string& nombre) {
+        motorReintento = nombre;
     }
     
-    int obtenerCantidadSudokus() const {
-        return sudokus.size();
+    /**
+     * Cuenta soluciones hasta 'maximo' en lugar de parar en la primera
+     */
+    void establecerConteo(long long maximo) {
+        maximoSoluciones = max(0LL, maximo);
+    }
+    
+    /**
+     * Resuelve una sola vez los sudokus equivalentes por simetría (no
+     * se aplica en modo conteo)
+     */
+    void establecerCache(bool activa) {
+        conCache = activa;
+    }
+    
+    /**
+     * Caché de soluciones en disco que se conserva entre ejecuciones;
+     * al superar 'maximoBytes' se descartan las entradas más antiguas
+     * (no se aplica en modo conteo)
+     */
+    void establecerCacheDisco(const string& ruta, uint64_t maximoBytes) {
+        rutaCacheDisco = ruta;
+        maximoCacheDisco = maximoBytes;
     }
 };
 
+/**
+ * Interpreta una lista separada por comas de técnicas a activar
+ * ("ninguna" las desactiva todas)
+ */
+TecnicasPropagacion parsearTecnicas(const string& lista) {
+    TecnicasPropagacion tecnicas;
+    tecnicas.singlesDesnudos = false;
+    tecnicas.singlesOcultos = false;
+    tecnicas.candidatosBloqueados = false;
+    tecnicas.subconjuntosDesnudos = false;
+    tecnicas.subconjuntosOcultos = false;
+    
+    size_t inicio = 0;
+    while (inicio <= lista.size()) {
+        size_t fin = lista.find(',', inicio);
+        if (fin == string::npos) fin = lista.size();
+        string nombre = lista.substr(inicio, fin - inicio);
+        
+        if (nombre == "singles-desnudos") tecnicas.singlesDesnudos = true;
+        else if (nombre == "singles-ocultos") tecnicas.singlesOcultos = true;
+        else if (nombre == "bloqueados") tecnicas.candidatosBloqueados = true;
+        else if (nombre == "subconjuntos-desnudos") tecnicas.subconjuntosDesnudos = true;
+        else if (nombre == "subconjuntos-ocultos") tecnicas.subconjuntosOcultos = true;
+        else if (nombre != "ninguna") throw runtime_error("Tecnica desconocida: " + nombre);
+        
+        inicio = fin + 1;
+    }
+    
+    return tecnicas;
+}
+
 int main(int argc, char* argv[]) {
     try {
         string archivoEntrada = "sudokus_entrada.txt";
         string archivoSalida = "sudokus_solucion.txt";
+        string motor = "hibrido";
+        TecnicasPropagacion tecnicas;
+        int hilos = 1;
+        int hilosBusqueda = 1;
+        size_t capacidadCola = 0;
+        string formato;
+        string archivoEstadisticas;
+        LimitesBusqueda limites;
+        string motorReintento;
+        long long maximoSoluciones = 0;
+        bool conCache = false;
+        string rutaCacheDisco;
+        uint64_t maximoCacheDisco = 256;
+        
+        // Uso: resolver [entrada] [salida] [--motor hibrido|dlx]
+        //               [--tecnicas t1,t2,...|ninguna] [--hilos N]
+        //               [--hilos-busqueda N] [--cola N]
+        //               [--formato texto|binario] [--estadisticas archivo.jsonl]
+        //               [--limite-tiempo SEG] [--limite-nodos N] [--reintento MOTOR]
+        //               [--contar N | --unicidad] [--cache]
+        //               [--cache-disco ruta] [--cache-disco-maximo MB]
+        vector<string> posicionales;
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--motor" && i + 1 < argc) {
+                motor = argv[++i];
+            } else if (arg == "--tecnicas" && i + 1 < argc) {
+                tecnicas = parsearTecnicas(argv[++i]);
+            } else if ((arg == "--hilos" || arg == "--threads") && i + 1 < argc) {
+                // 0 = un hilo por núcleo
+                hilos = stoi(argv[++i]);
+                if (hilos == 0) hilos = thread::hardware_concurrency();
+            } else if (arg == "--hilos-busqueda" && i + 1 < argc) {
+                // Reparte la búsqueda de cada sudoku (solo motor hibrido)
+                hilosBusqueda = stoi(argv[++i]);
+                if (hilosBusqueda == 0) hilosBusqueda = thread::hardware_concurrency();
+            } else if (arg == "--cola" && i + 1 < argc) {
+                // Sudokus en vuelo entre etapas (0 = automática)
+                capacidadCola = stoul(argv[++i]);
+            } else if (arg == "--estadisticas" && i + 1 < argc) {
+                archivoEstadisticas = argv[++i];
+            } else if (arg == "--limite-tiempo" && i + 1 < argc) {
+                limites.segundos = stod(argv[++i]);
+            } else if (arg == "--limite-nodos" && i + 1 < argc) {
+                limites.nodos = stoll(argv[++i]);
+            } else if (arg == "--reintento" && i + 1 < argc) {
+                motorReintento = argv[++i];
+            } else if (arg == "--contar" && i + 1 < argc) {
+                // Cuenta soluciones hasta N (con --hilos-busqueda, en paralelo)
+                maximoSoluciones = stoll(argv[++i]);
+            } else if (arg == "--unicidad") {
+                // Dos soluciones bastan para saber que no es única
+                maximoSoluciones = 2;
+            } else if (arg == "--cache") {
+                // Sudokus equivalentes por simetría se resuelven una vez
+                conCache = true;
+            } else if (arg == "--cache-disco" && i + 1 < argc) {
+                // Soluciones que se conservan entre ejecuciones
+                rutaCacheDisco = argv[++i];
+            } else if (arg == "--cache-disco-maximo" && i + 1 < argc) {
+                maximoCacheDisco = stoull(argv[++i]);
+            } else if (arg == "--formato" && i + 1 < argc) {
+                // Formato de la salida; la entrada se detecta sola
+                formato = argv[++i];
+                if (formato != "texto" && formato != "binario") {
+                    throw runtime_error("Formato desconocido: " + formato);
+                }
+            } else {
+                posicionales.push_back(arg);
+            }
+        }
         
-        if (argc > 1) archivoEntrada = argv[1];
-        if (argc > 2) archivoSalida = argv[2];
+        if (posicionales.size() > 0) archivoEntrada = posicionales[0];
+        if (posicionales.size() > 1) archivoSalida = posicionales[1];
         
         cout << "=== RESOLVEDOR HIBRIDO N-SUDOKU ===" << endl << endl;
         
         ProcesadorMultipleSudoku procesador;
-        
-        cout << "Leyendo: " << archivoEntrada << endl;
-        procesador.leerArchivo(archivoEntrada);
-        
-        cout << "Sudokus encontrados: " << procesador.obtenerCantidadSudokus() << endl << endl;
-        
-        if (procesador.obtenerCantidadSudokus() == 0) {
+        procesador.establecerMotor(motor);
+        procesador.establecerTecnicas(tecnicas);
+        procesador.establecerHilos(hilos);
+        procesador.establecerHilosBusqueda(hilosBusqueda);
+        procesador.establecerCapacidadCola(capacidadCola);
+        procesador.establecerArchivoEstadisticas(archivoEstadisticas);
+        procesador.establecerLimites(limites);
+        procesador.establecerMotorReintento(motorReintento);
+        procesador.establecerConteo(maximoSoluciones);
+        procesador.establecerCache(conCache);
+        procesador.establecerCacheDisco(rutaCacheDisco, maximoCacheDisco << 20);
+        
+        // Sin --formato, las salidas .sdkb se escriben en binario
+        bool extensionBinaria = archivoSalida.size() >= 5 &&
+                                archivoSalida.compare(archivoSalida.size() - 5, 5, ".sdkb") == 0;
+        procesador.establecerSalidaBinaria(formato == "binario" || (formato.empty() && extensionBinaria));
+        cout << "Motor: " << motor << endl;
+        
+        cout << "Leyendo: " << archivoEntrada << endl << endl;
+        size_t procesados = procesador.procesarArchivo(archivoEntrada, archivoSalida);
+        
+        if (procesados == 0) {
             cout << "No se encontraron sudokus." << endl;
             return 1;
         }
         
-        procesador.resolverTodos(archivoSalida);
-        
+        cout << "Sudokus procesados: " << procesados << endl;
         cout << "\nCompletado" << endl;
         
     } catch (const exception& e) {
@@ -0,0 +1,410 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <set>
+#include <csignal>
+
+#include <sys/stat.h>
+#include <poll.h>
+
+#include "MotoresSudoku.h"
+#include "LectorSudokus.h"
+#include "EscritorSudokus.h"
+#include "FormatoBinario.h"
+#include "ColasConcurrentes.h"
+#include "ProtocoloServidor.h"
+
+using namespace std;
+
+static volatile sig_atomic_t detenerServidor = 0;
+
+static void alRecibirSenal(int) {
+    detenerServidor = 1;
+}
+
+/**
+ * Estado de una conexión. Las respuestas se reordenan en 'respuestas' y
+ * el hilo de escritura las envía en orden; 'enVuelo' limita cuántas
+ * peticiones de la conexión hay sin responder, para que los trabajadores
+ * nunca esperen en la ventana de una conexión lenta.
+ */
+struct ConexionCliente {
+    int fd;
+    bool binaria = false;
+    VentanaOrdenada<string> respuestas;
+    mutex mtx;
+    condition_variable hayHueco;
+    size_t enVuelo = 0;
+    size_t maximoEnVuelo;
+
+    ConexionCliente(int descriptor, size_t ventana)
+        : fd(descriptor), respuestas(ventana), maximoEnVuelo(ventana) {}
+};
+
+// El tablero se sobrescribe con la solución
+struct PeticionSudoku {
+    shared_ptr<ConexionCliente> conexion;
+    size_t secuencia = 0;
+    string etiqueta;     // vacía en binario
+    int n = 0;
+    bool valida = true;
+    vector<int> celdas;
+};
+
+/**
+ * Servidor de sudokus sobre un socket Unix (protocolo en
+ * ProtocoloServidor.h). Un hilo por conexión lee y separa las peticiones,
+ * un grupo fijo de trabajadores con resolvedores ya creados las resuelve
+ * y otro hilo por conexión escribe las respuestas en orden, agrupando
+ * en un solo envío las que ya estén listas.
+ */
+class ServidorSudokus {
+private:
+    static const size_t TAMANO_LECTURA = 1 << 16;
+    static const size_t MAXIMO_ENVIO = 1 << 20;
+    // Bytes sin consumir que se guardan de una conexión; el bloque de texto
+    // más grande (100x100) ocupa unos 30 KB
+    static const size_t MAXIMO_PENDIENTE = 1 << 20;
+
+    string motor = "hibrido";
+    int hilos = 1;
+    size_t ventana = 256;
+    LimitesBusqueda limites;
+
+    unique_ptr<ColaAcotada<PeticionSudoku>> pendientes;
+    atomic<size_t> resueltos{0};
+    atomic<size_t> conexionesTotales{0};
+
+    // Conexiones abiertas, para cortarlas al detener el servidor
+    mutex mtxConexiones;
+    condition_variable sinConexiones;
+    set<int> abiertas;
+
+    void encolar(const shared_ptr<ConexionCliente>& conexion, PeticionSudoku& peticion) {
+        {
+            unique_lock<mutex> lock(conexion->mtx);
+            conexion->hayHueco.wait(lock, [&] { return conexion->enVuelo < conexion->maximoEnVuelo; });
+            conexion->enVuelo++;
+        }
+        peticion.conexion = conexion;
+        pendientes->poner(move(peticion));
+    }
+
+    void escribirRespuestas(shared_ptr<ConexionCliente> conexion) {
+        string respuesta, salida;
+        bool cerrada = false;
+        while (conexion->respuestas.sacar(respuesta)) {
+            salida.swap(respuesta);
+            size_t cuantas = 1;
+            while (salida.size() < MAXIMO_ENVIO && conexion->respuestas.intentarSacar(respuesta)) {
+                salida += respuesta;
+                cuantas++;
+            }
+
+            // Si el cliente ya no lee se siguen descontando las respuestas
+            if (!cerrada) {
+                cerrada = !enviarTodo(conexion->fd, salida.data(), salida.size());
+            }
+            {
+                lock_guard<mutex> lock(conexion->mtx);
+                conexion->enVuelo -= cuantas;
+            }
+            conexion->hayHueco.notify_all();
+        }
+    }
+
+    /**
+     * Lee peticiones de la conexión hasta que el cliente cierra o hay un
+     * error de protocolo, espera a que salgan todas las respuestas y
+     * cierra el socket
+     */
+    void atenderConexion(int fd) {
+        auto conexion = make_shared<ConexionCliente>(fd, ventana);
+        thread escritura(&ServidorSudokus::escribirRespuestas, this, conexion);
+
+        LectorSudokus lector;
+        lector.configurarInvalidos(true);
+        PeticionSudoku peticion;
+        size_t secuencia = 0;
+        bool decidido = false;
+        bool error = false;
+        string bufer;
+        vector<char> trozo(TAMANO_LECTURA);
+
+        // Todo bloque de texto recibe respuesta; los que no son un tablero
+        // admitido se responden como "Dimensiones invalidas" sin resolver
+        auto encolarTexto = [&](const TableroPlano& sudoku) {
+            peticion.secuencia = secuencia++;
+            peticion.etiqueta.assign(sudoku.etiqueta.data(), sudoku.etiqueta.size());
+            peticion.n = sudoku.n;
+            peticion.valida = sudoku.tamano > 0 && sudoku.tamano <= 100;
+            if (peticion.valida) {
+                peticion.celdas.assign(sudoku.celdas, sudoku.celdas + sudoku.tamano * sudoku.tamano);
+            }
+            encolar(conexion, peticion);
+        };
+
+        while (!error) {
+            ssize_t leidos = recv(fd, trozo.data(), trozo.size(), 0);
+            if (leidos < 0 && errno == EINTR) continue;
+            if (leidos <= 0) break;
+            bufer.append(trozo.data(), (size_t)leidos);
+
+            // El modo se decide con los primeros bytes
+            if (!decidido) {
+                size_t comparados = min(bufer.size(), sizeof(FIRMA_BINARIA));
+                bool prefijo = memcmp(bufer.data(), FIRMA_BINARIA, comparados) == 0;
+                if (prefijo && comparados < sizeof(FIRMA_BINARIA)) continue;
+                conexion->binaria = prefijo;
+                if (prefijo) bufer.erase(0, sizeof(FIRMA_BINARIA));
+                decidido = true;
+            }
+
+            size_t consumidos = 0;
+            if (conexion->binaria) {
+                while (consumidos < bufer.size()) {
+                    int n = (uint8_t)bufer[consumidos];
+                    if (n < 2 || n > 10) {
+                        error = true;
+                        break;
+                    }
+                    size_t largo = 1 + bytesCeldas(n);
+                    if (bufer.size() - consumidos < largo) break;
+
+                    peticion.secuencia = secuencia++;
+                    peticion.n = n;
+                    peticion.celdas.resize((size_t)n * n * n * n);
+                    peticion.valida = desempaquetarCeldas((const uint8_t*)bufer.data() + consumidos + 1, n,
+                                                          peticion.celdas.data());
+                    encolar(conexion, peticion);
+                    consumidos += largo;
+                }
+            } else {
+                consumidos = lector.leerBloquesCompletos(bufer.data(), bufer.size(), encolarTexto);
+            }
+            bufer.erase(0, consumidos);
+
+            // Un cliente que no termina nunca su bloque no puede llenar la memoria
+            if (bufer.size() > MAXIMO_PENDIENTE) {
+                error = true;
+            }
+        }
+
+        // Al cerrar el cliente, el último bloque de texto se cierra aunque
+        // le falten filas o el salto de línea final
+        if (!error && decidido && !conexion->binaria && !bufer.empty()) {
+            lector.leerBufer(bufer.data(), bufer.size(), encolarTexto);
+        }
+
+        {
+            unique_lock<mutex> lock(conexion->mtx);
+            conexion->hayHueco.wait(lock, [&] { return conexion->enVuelo == 0; });
+        }
+        conexion->respuestas.cerrar();
+        escritura.join();
+
+        // Se avisa con el mutex tomado: al soltarlo 'ejecutar' puede
+        // terminar y destruir el servidor
+        lock_guard<mutex> lock(mtxConexiones);
+        abiertas.erase(fd);
+        close(fd);
+        sinConexiones.notify_all();
+    }
+
+    void resolverPeticiones(ResolvedorSudoku& resolvedor) {
+        PeticionSudoku peticion;
+        FormateadorTexto formateador;
+
+        while (pendientes->sacar(peticion)) {
+            int estado = RESPUESTA_INVALIDA;
+            if (peticion.valida) {
+                resolvedor.cargarSudoku(peticion.celdas.data(), peticion.n);
+                if (resolvedor.resolverSudoku()) {
+                    resolvedor.copiarSolucion(peticion.celdas.data());
+                    estado = RESPUESTA_RESUELTO;
+                } else {
+                    estado = resolvedor.limiteAgotado() ? RESPUESTA_TIEMPO_AGOTADO : RESPUESTA_SIN_SOLUCION;
+                }
+            }
+
+            string respuesta;
+            if (peticion.conexion->binaria) {
+                respuesta.push_back((char)estado);
+                if (estado == RESPUESTA_RESUELTO) {
+                    empaquetarCeldas(peticion.celdas.data(), peticion.n, respuesta);
+                }
+            } else {
+                respuesta = peticion.etiqueta;
+                respuesta.push_back('\n');
+                if (estado == RESPUESTA_RESUELTO) {
+                    formateador.anadirFilas(respuesta, peticion.celdas.data(), peticion.n);
+                } else {
+                    int motivo = estado == RESPUESTA_TIEMPO_AGOTADO ? MOTIVO_TIEMPO_AGOTADO :
+                                 estado == RESPUESTA_INVALIDA ? MOTIVO_DIMENSIONES_INVALIDAS : MOTIVO_SIN_SOLUCION;
+                    respuesta += textoMotivo(motivo);
+                    respuesta.push_back('\n');
+                }
+                respuesta.push_back('\n');
+            }
+
+            peticion.conexion->respuestas.poner(peticion.secuencia, move(respuesta));
+            peticion.conexion.reset();
+            resueltos++;
+        }
+    }
+
+    int abrirSocket(const string& ruta) {
+        sockaddr_un direccion = direccionUnix(ruta);
+
+        // Un socket que quedó de una ejecución anterior se reemplaza
+        struct stat info;
+        if (stat(ruta.c_str(), &info) == 0) {
+            if (!S_ISSOCK(info.st_mode)) {
+                throw runtime_error("La ruta existe y no es un socket: " + ruta);
+            }
+            unlink(ruta.c_str());
+        }
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || bind(fd, (sockaddr*)&direccion, sizeof(direccion)) != 0 || listen(fd, 128) != 0) {
+            string motivo = strerror(errno);
+            if (fd >= 0) close(fd);
+            throw runtime_error("No se pudo escuchar en: " + ruta + " (" + motivo + ")");
+        }
+        return fd;
+    }
+
+public:
+    /**
+     * Atiende conexiones en 'ruta' hasta recibir SIGINT o SIGTERM; las
+     * peticiones ya recibidas se responden antes de salir
+     */
+    void ejecutar(const string& ruta) {
+        // Se crean antes de escuchar para que un motor desconocido falle pronto
+        vector<unique_ptr<ResolvedorSudoku>> resolvedores;
+        for (int h = 0; h < hilos; h++) {
+            resolvedores.push_back(crearResolvedor(motor, TecnicasPropagacion(), 1, false, limites));
+        }
+        pendientes.reset(new ColaAcotada<PeticionSudoku>(16 * (size_t)hilos));
+
+        int escucha = abrirSocket(ruta);
+        vector<thread> trabajadores;
+        for (int h = 0; h < hilos; h++) {
+            trabajadores.emplace_back(&ServidorSudokus::resolverPeticiones, this, ref(*resolvedores[h]));
+        }
+
+        cout << "Escuchando en: " << ruta << " (" << hilos << " hilos)" << endl;
+
+        // poll con espera corta para notar la señal sin depender de EINTR
+        while (!detenerServidor) {
+            pollfd espera = { escucha, POLLIN, 0 };
+            if (poll(&espera, 1, 200) <= 0) continue;
+
+            int fd = accept(escucha, nullptr, nullptr);
+            if (fd < 0) continue;
+            {
+                lock_guard<mutex> lock(mtxConexiones);
+                abiertas.insert(fd);
+            }
+            conexionesTotales++;
+            thread(&ServidorSudokus::atenderConexion, this, fd).detach();
+        }
+
+        close(escucha);
+        unlink(ruta.c_str());
+
+        // Cortar la lectura hace que cada conexión termine lo pendiente y cierre
+        {
+            unique_lock<mutex> lock(mtxConexiones);
+            for (int fd : abiertas) {
+                shutdown(fd, SHUT_RD);
+            }
+            sinConexiones.wait(lock, [&] { return abiertas.empty(); });
+        }
+
+        pendientes->cerrar();
+        for (auto& t : trabajadores) {
+            t.join();
+        }
+
+        cout << "\nConexiones: " << conexionesTotales << ", sudokus respondidos: " << resueltos << endl;
+    }
+
+    void establecerMotor(const string& nombre) {
+        motor = nombre;
+    }
+
+    void establecerHilos(int cantidad) {
+        hilos = max(1, cantidad);
+    }
+
+    /**
+     * Peticiones sin responder que admite cada conexión
+     */
+    void establecerVentana(size_t cantidad) {
+        ventana = max<size_t>(1, cantidad);
+    }
+
+    void establecerLimites(const LimitesBusqueda& nuevos) {
+        limites = nuevos;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    try {
+        string ruta = RUTA_SOCKET_POR_DEFECTO;
+        string motor = "hibrido";
+        int hilos = (int)thread::hardware_concurrency();
+        size_t ventana = 256;
+        LimitesBusqueda limites;
+
+        // Uso: servidor [--socket ruta] [--motor hibrido|dlx] [--hilos N]
+        //               [--ventana N] [--limite-tiempo SEG] [--limite-nodos N]
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--socket" && i + 1 < argc) {
+                ruta = argv[++i];
+            } else if (arg == "--motor" && i + 1 < argc) {
+                motor = argv[++i];
+            } else if ((arg == "--hilos" || arg == "--threads") && i + 1 < argc) {
+                // 0 = un hilo por núcleo
+                hilos = stoi(argv[++i]);
+                if (hilos == 0) hilos = thread::hardware_concurrency();
+            } else if (arg == "--ventana" && i + 1 < argc) {
+                ventana = stoul(argv[++i]);
+            } else if (arg == "--limite-tiempo" && i + 1 < argc) {
+                limites.segundos = stod(argv[++i]);
+            } else if (arg == "--limite-nodos" && i + 1 < argc) {
+                limites.nodos = stoll(argv[++i]);
+            } else {
+                throw runtime_error("Argumento desconocido: " + arg);
+            }
+        }
+
+        signal(SIGINT, alRecibirSenal);
+        signal(SIGTERM, alRecibirSenal);
+        signal(SIGPIPE, SIG_IGN);
+
+        cout << "=== SERVIDOR N-SUDOKU ===" << endl << endl;
+        cout << "Motor: " << motor << endl;
+
+        ServidorSudokus servidor;
+        servidor.establecerMotor(motor);
+        servidor.establecerHilos(hilos);
+        servidor.establecerVentana(ventana);
+        servidor.establecerLimites(limites);
+        servidor.ejecutar(ruta);
+
+    } catch (const exception& e) {
+        cerr << "Error: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,39 @@
+#ifndef UTILIDADES_JSON_H
+#define UTILIDADES_JSON_H
+
+#include <string>
+
+using namespace std;
+
+/**
+ * Escapa un texto para ponerlo entre comillas en una línea JSON, como las
+ * de --estadisticas de Resolver, --json de Calificar y las de Rendimiento.
+ * Las etiquetas salen del archivo de entrada y pueden traer comillas,
+ * barras o caracteres de control.
+ */
+inline string escaparJson(const string& texto) {
+    static const char hex[] = "0123456789abcdef";
+    string resultado;
+    resultado.reserve(texto.size());
+    for (char c : texto) {
+        unsigned char u = (unsigned char)c;
+        switch (c) {
+            case '"':  resultado += "\\\""; break;
+            case '\\': resultado += "\\\\"; break;
+            case '\n': resultado += "\\n"; break;
+            case '\r': resultado += "\\r"; break;
+            case '\t': resultado += "\\t"; break;
+            default:
+                if (u < 0x20) {
+                    resultado += "\\u00";
+                    resultado.push_back(hex[u >> 4]);
+                    resultado.push_back(hex[u & 0xf]);
+                } else {
+                    resultado.push_back(c);
+                }
+        }
+    }
+    return resultado;
+}
+
+#endif
@@ -0,0 +1,176 @@
+#ifndef VALIDADOR_BITS_H
+#define VALIDADOR_BITS_H
+
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VALIDADOR_SSE2
+#endif
+
+/**
+ * Validador de tableros por máscaras de bits, compartido por Validar.cpp
+ * y Resolver.cpp. Cada celda se convierte en una máscara de 32 bits
+ * (bit v - 1 para el valor v, 0 si está vacía); una unidad tiene
+ * repetidos si el OR de sus máscaras tiene menos bits que celdas llenas.
+ */
+
+enum ErrorTablero {
+    TABLERO_VALIDO,
+    ERROR_RANGO,        // algún valor fuera de [0, n²]
+    ERROR_FILA,
+    ERROR_COLUMNA,
+    ERROR_SUBCUADRADO
+};
+
+inline int contarBitsValidador(uint32_t mascara) {
+#if defined(_MSC_VER)
+    return __popcnt(mascara);
+#else
+    return __builtin_popcount(mascara);
+#endif
+}
+
+/**
+ * orDestino[k] |= bits[k] y cuentaDestino[k] += (bits[k] != 0) para
+ * k en [0, cantidad), por carriles de 8 (AVX2) o 4 (SSE2)
+ */
+inline void acumularMascaras(uint32_t* orDestino, int32_t* cuentaDestino,
+                             const uint32_t* bits, int cantidad) {
+    int k = 0;
+#if defined(__AVX2__)
+    const __m256i cero = _mm256_setzero_si256();
+    for (; k + 8 <= cantidad; k += 8) {
+        __m256i b = _mm256_loadu_si256((const __m256i*)(bits + k));
+        __m256i o = _mm256_loadu_si256((const __m256i*)(orDestino + k));
+        __m256i c = _mm256_loadu_si256((const __m256i*)(cuentaDestino + k));
+        // cmpgt da -1 en los carriles no vacíos (las máscaras caben en 31 bits)
+        c = _mm256_sub_epi32(c, _mm256_cmpgt_epi32(b, cero));
+        _mm256_storeu_si256((__m256i*)(orDestino + k), _mm256_or_si256(o, b));
+        _mm256_storeu_si256((__m256i*)(cuentaDestino + k), c);
+    }
+#elif defined(VALIDADOR_SSE2)
+    const __m128i cero = _mm_setzero_si128();
+    for (; k + 4 <= cantidad; k += 4) {
+        __m128i b = _mm_loadu_si128((const __m128i*)(bits + k));
+        __m128i o = _mm_loadu_si128((const __m128i*)(orDestino + k));
+        __m128i c = _mm_loadu_si128((const __m128i*)(cuentaDestino + k));
+        c = _mm_sub_epi32(c, _mm_cmpgt_epi32(b, cero));
+        _mm_storeu_si128((__m128i*)(orDestino + k), _mm_or_si128(o, b));
+        _mm_storeu_si128((__m128i*)(cuentaDestino + k), c);
+    }
+#endif
+    for (; k < cantidad; k++) {
+        orDestino[k] |= bits[k];
+        cuentaDestino[k] += bits[k] != 0;
+    }
+}
+
+/**
+ * OR de 'cantidad' máscaras consecutivas
+ */
+inline uint32_t reducirOr(const uint32_t* bits, int cantidad) {
+    int k = 0;
+    uint32_t resultado = 0;
+#if defined(__AVX2__)
+    __m256i acc = _mm256_setzero_si256();
+    for (; k + 8 <= cantidad; k += 8) {
+        acc = _mm256_or_si256(acc, _mm256_loadu_si256((const __m256i*)(bits + k)));
+    }
+    __m128i mitad = _mm_or_si128(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    mitad = _mm_or_si128(mitad, _mm_shuffle_epi32(mitad, _MM_SHUFFLE(1, 0, 3, 2)));
+    mitad = _mm_or_si128(mitad, _mm_shuffle_epi32(mitad, _MM_SHUFFLE(2, 3, 0, 1)));
+    resultado = (uint32_t)_mm_cvtsi128_si32(mitad);
+#elif defined(VALIDADOR_SSE2)
+    __m128i acc = _mm_setzero_si128();
+    for (; k + 4 <= cantidad; k += 4) {
+        acc = _mm_or_si128(acc, _mm_loadu_si128((const __m128i*)(bits + k)));
+    }
+    acc = _mm_or_si128(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_or_si128(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    resultado = (uint32_t)_mm_cvtsi128_si32(acc);
+#endif
+    for (; k < cantidad; k++) {
+        resultado |= bits[k];
+    }
+    return resultado;
+}
+
+/**
+ * Valida un tablero plano de n² x n² celdas (fila * n² + col, 0 = vacía)
+ * recorriéndolo una sola vez: cada fila se convierte a máscaras y se
+ * acumula a la vez en su fila, en las columnas y en sus bloques.
+ * Los tableros de más de 32 símbolos usan un camino escalar.
+ */
+template <typename Celda>
+ErrorTablero validarTableroPlano(const Celda* celdas, int n) {
+    const int tamano = n * n;
+    
+    if (tamano > 32) {
+        std::vector<char> vistos(3 * tamano * (tamano + 1), 0);
+        for (int i = 0; i < tamano; i++) {
+            for (int j = 0; j < tamano; j++) {
+                long long valor = celdas[i * tamano + j];
+                if (valor < 0 || valor > tamano) return ERROR_RANGO;
+            }
+        }
+        const ErrorTablero errores[3] = {ERROR_FILA, ERROR_COLUMNA, ERROR_SUBCUADRADO};
+        for (int tipo = 0; tipo < 3; tipo++) {
+            for (int i = 0; i < tamano; i++) {
+                for (int j = 0; j < tamano; j++) {
+                    int valor = (int)celdas[i * tamano + j];
+                    if (valor == 0) continue;
+                    int unidad = tipo == 0 ? i : tipo == 1 ? j : (i / n) * n + j / n;
+                    char& visto = vistos[(tipo * tamano + unidad) * (tamano + 1) + valor];
+                    if (visto) return errores[tipo];
+                    visto = 1;
+                }
+            }
+        }
+        return TABLERO_VALIDO;
+    }
+    
+    uint32_t bitsFila[32];
+    uint32_t filaOr[32], colOr[32] = {}, bloqueOr[32] = {};
+    int32_t filaCuenta[32] = {}, colCuenta[32] = {}, bloqueCuenta[32] = {};
+    
+    for (int i = 0; i < tamano; i++) {
+        const Celda* fila = celdas + i * tamano;
+        int bloqueInicio = (i / n) * n;
+        
+        for (int j = 0; j < tamano; j++) {
+            long long valor = fila[j];
+            if (valor < 0 || valor > tamano) return ERROR_RANGO;
+            
+            uint32_t bit = valor ? 1u << (valor - 1) : 0;
+            bitsFila[j] = bit;
+            filaCuenta[i] += valor != 0;
+            bloqueOr[bloqueInicio + j / n] |= bit;
+            bloqueCuenta[bloqueInicio + j / n] += valor != 0;
+        }
+        
+        filaOr[i] = reducirOr(bitsFila, tamano);
+        acumularMascaras(colOr, colCuenta, bitsFila, tamano);
+    }
+    
+    for (int k = 0; k < tamano; k++) {
+        if (contarBitsValidador(filaOr[k]) != filaCuenta[k]) return ERROR_FILA;
+    }
+    for (int k = 0; k < tamano; k++) {
+        if (contarBitsValidador(colOr[k]) != colCuenta[k]) return ERROR_COLUMNA;
+    }
+    for (int k = 0; k < tamano; k++) {
+        if (contarBitsValidador(bloqueOr[k]) != bloqueCuenta[k]) return ERROR_SUBCUADRADO;
+    }
+    
+    return TABLERO_VALIDO;
+}
+
+#endif
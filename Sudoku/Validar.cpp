@@ -1,11 +1,19 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
-#include <set>
 #include <string>
 #include <cmath>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <deque>
+#include <unordered_map>
+#include <chrono>
+
+#include "ValidadorBits.h"
+#include "LectorSudokus.h"
 
 using namespace std;
 
@@ -52,101 +60,15 @@ private:
     }
     
     /**
-     * Valida que no haya símbolos repetidos en ninguna fila
+     * Valida filas, columnas y subcuadrados de una pasada con el
+     * validador de máscaras de bits
      */
-    bool validarFilas() {
+    ErrorTablero validarUnidades() {
+        vector<int> plano(tamano * tamano);
         for (int i = 0; i < tamano; i++) {
-            set<int> simbolos;
-            
-            for (int j = 0; j < tamano; j++) {
-                int valor = sudoku[i][j];
-                
-                // Ignorar celdas vacías
-                if (valor == 0) continue;
-                
-                // Verificar rango válido [1, n²]
-                if (valor < 1 || valor > tamano) {
-                    return false;
-                }
-                
-                // Verificar duplicados
-                if (simbolos.count(valor) > 0) {
-                    return false;
-                }
-                
-                simbolos.insert(valor);
-            }
-        }
-        
-        return true;
-    }
-    
-    /**
-     * Valida que no haya símbolos repetidos en ninguna columna
-     */
-    bool validarColumnas() {
-        for (int j = 0; j < tamano; j++) {
-            set<int> simbolos;
-            
-            for (int i = 0; i < tamano; i++) {
-                int valor = sudoku[i][j];
-                
-                // Ignorar celdas vacías
-                if (valor == 0) continue;
-                
-                // Verificar rango válido [1, n²]
-                if (valor < 1 || valor > tamano) {
-                    return false;
-                }
-                
-                // Verificar duplicados
-                if (simbolos.count(valor) > 0) {
-                    return false;
-                }
-                
-                simbolos.insert(valor);
-            }
-        }
-        
-        return true;
-    }
-    
-    /**
-     * Valida que no haya símbolos repetidos en ningún subcuadrado n x n
-     */
-    bool validarSubcuadrados() {
-        // Iterar sobre cada subcuadrado
-        for (int filaBloque = 0; filaBloque < n; filaBloque++) {
-            for (int colBloque = 0; colBloque < n; colBloque++) {
-                set<int> simbolos;
-                
-                // Extraer símbolos del subcuadrado actual
-                for (int i = 0; i < n; i++) {
-                    for (int j = 0; j < n; j++) {
-                        int fila = filaBloque * n + i;
-                        int col = colBloque * n + j;
-                        int valor = sudoku[fila][col];
-                        
-                        // Ignorar celdas vacías
-                        if (valor == 0) continue;
-                        
-                        // Verificar rango válido [1, n²]
-                        if (valor < 1 || valor > tamano) {
-                            return false;
-                        }
-                        
-                        // Verificar duplicados
-                        if (simbolos.count(valor) > 0) {
-                            return false;
-                        }
-                        
-                        simbolos.insert(valor);
-                    }
-                }
-            }
+            copy(sudoku[i].begin(), sudoku[i].end(), plano.begin() + i * tamano);
         }
-        
-        return true;
+        return validarTableroPlano(plano.data(), n);
     }
     
 public:
@@ -230,25 +152,22 @@ public:
                 return resultado;
             }
             
-            // Validar filas
-            if (!validarFilas()) {
-                resultado.esValido = false;
-                resultado.mensaje = "Error: Hay símbolos repetidos en alguna fila";
-                return resultado;
-            }
-            
-            // Validar columnas
-            if (!validarColumnas()) {
-                resultado.esValido = false;
-                resultado.mensaje = "Error: Hay simbolos repetidos en alguna columna";
-                return resultado;
-            }
-            
-            // Validar subcuadrados
-            if (!validarSubcuadrados()) {
-                resultado.esValido = false;
-                resultado.mensaje = "Error: Hay simbolos repetidos en algún subcuadrado";
-                return resultado;
+            switch (validarUnidades()) {
+                case ERROR_RANGO:
+                case ERROR_FILA:
+                    resultado.esValido = false;
+                    resultado.mensaje = "Error: Hay símbolos repetidos en alguna fila";
+                    return resultado;
+                case ERROR_COLUMNA:
+                    resultado.esValido = false;
+                    resultado.mensaje = "Error: Hay simbolos repetidos en alguna columna";
+                    return resultado;
+                case ERROR_SUBCUADRADO:
+                    resultado.esValido = false;
+                    resultado.mensaje = "Error: Hay simbolos repetidos en algún subcuadrado";
+                    return resultado;
+                case TABLERO_VALIDO:
+                    break;
             }
             
             resultado.esValido = true;
@@ -309,16 +228,276 @@ public:
     }
 };
 
+/**
+ * Totales de una validación por lotes
+ */
+struct ResumenLote {
+    long long total = 0;
+    long long validos = 0;
+    long long incompletos = 0;
+    long long invalidos = 0;
+    long long pistasAlteradas = 0;
+    long long sinSolucion = 0;
+    long long tiempoAgotado = 0;
+    long long sinEntrada = 0;
+    size_t bytes = 0;
+};
+
+/**
+ * Valida archivos con muchos sudokus etiquetados (p. ej. la salida del
+ * resolvedor). El archivo se recorre en streaming: los tableros se
+ * agrupan en bloques que se validan en paralelo y se informan en orden.
+ * Opcionalmente cada tablero se compara con el sudoku de entrada de
+ * igual etiqueta para comprobar que conserva las pistas.
+ */
+class ValidadorLote {
+private:
+    enum EstadoTablero { VALIDO, INCOMPLETO, INVALIDO, PISTAS_ALTERADAS, SIN_SOLUCION, TIEMPO_AGOTADO, SIN_ENTRADA };
+    
+    struct TareaValidacion {
+        string etiqueta;
+        int n = 0;
+        vector<int> tablero;        // plano; vacío si el bloque no tenía tablero
+        int motivo = MOTIVO_SIN_SOLUCION;   // de los bloques sin tablero
+        vector<int> entrada;        // plano; vacío si no hay entrada asociada
+        bool sinEntrada = false;    // se cargó entrada pero la etiqueta no aparece
+        EstadoTablero estado = VALIDO;
+        ErrorTablero error = TABLERO_VALIDO;
+    };
+    
+    static const size_t TAMANO_BLOQUE = 4096;
+    
+    // Sudokus de entrada por etiqueta; las etiquetas repetidas se consumen en orden
+    unordered_map<string, deque<vector<int>>> entradas;
+    bool conEntrada = false;
+    int hilos = 1;
+    
+    static void validarTarea(TareaValidacion& tarea) {
+        if (tarea.tablero.empty()) {
+            tarea.estado = tarea.motivo == MOTIVO_TIEMPO_AGOTADO ? TIEMPO_AGOTADO : SIN_SOLUCION;
+            return;
+        }
+        
+        tarea.error = validarTableroPlano(tarea.tablero.data(), tarea.n);
+        if (tarea.error != TABLERO_VALIDO) {
+            tarea.estado = INVALIDO;
+            return;
+        }
+        
+        if (tarea.sinEntrada) {
+            tarea.estado = SIN_ENTRADA;
+            return;
+        }
+        
+        if (!tarea.entrada.empty()) {
+            if (tarea.entrada.size() != tarea.tablero.size()) {
+                tarea.estado = PISTAS_ALTERADAS;
+                return;
+            }
+            for (size_t k = 0; k < tarea.tablero.size(); k++) {
+                if (tarea.entrada[k] != 0 && tarea.entrada[k] != tarea.tablero[k]) {
+                    tarea.estado = PISTAS_ALTERADAS;
+                    return;
+                }
+            }
+        }
+        
+        if (find(tarea.tablero.begin(), tarea.tablero.end(), 0) != tarea.tablero.end()) {
+            tarea.estado = INCOMPLETO;
+            return;
+        }
+        
+        tarea.estado = VALIDO;
+    }
+    
+    void procesarBloque(vector<TareaValidacion>& bloque, ResumenLote& resumen) {
+        atomic<size_t> siguiente(0);
+        auto trabajador = [&]() {
+            for (size_t k = siguiente++; k < bloque.size(); k = siguiente++) {
+                validarTarea(bloque[k]);
+            }
+        };
+        
+        vector<thread> trabajadores;
+        for (int h = 1; h < hilos; h++) {
+            trabajadores.emplace_back(trabajador);
+        }
+        trabajador();
+        for (auto& t : trabajadores) {
+            t.join();
+        }
+        
+        for (const auto& tarea : bloque) {
+            resumen.total++;
+            switch (tarea.estado) {
+                case VALIDO:
+                    resumen.validos++;
+                    break;
+                case INCOMPLETO:
+                    resumen.incompletos++;
+                    cout << "  " << tarea.etiqueta << ": incompleto" << endl;
+                    break;
+                case INVALIDO:
+                    resumen.invalidos++;
+                    cout << "  " << tarea.etiqueta << ": " << describirError(tarea.error) << endl;
+                    break;
+                case PISTAS_ALTERADAS:
+                    resumen.pistasAlteradas++;
+                    cout << "  " << tarea.etiqueta << ": no conserva las pistas de la entrada" << endl;
+                    break;
+                case SIN_SOLUCION:
+                    resumen.sinSolucion++;
+                    cout << "  " << tarea.etiqueta << ": sin solucion" << endl;
+                    break;
+                case TIEMPO_AGOTADO:
+                    resumen.tiempoAgotado++;
+                    cout << "  " << tarea.etiqueta << ": tiempo agotado" << endl;
+                    break;
+                case SIN_ENTRADA:
+                    resumen.sinEntrada++;
+                    cout << "  " << tarea.etiqueta << ": no aparece en la entrada" << endl;
+                    break;
+            }
+        }
+        
+        bloque.clear();
+    }
+    
+public:
+    static string describirError(ErrorTablero error) {
+        switch (error) {
+            case ERROR_RANGO: return "simbolos fuera de rango";
+            case ERROR_FILA: return "simbolos repetidos en alguna fila";
+            case ERROR_COLUMNA: return "simbolos repetidos en alguna columna";
+            case ERROR_SUBCUADRADO: return "simbolos repetidos en algun subcuadrado";
+            default: return "valido";
+        }
+    }
+    
+    void establecerHilos(int cantidad) {
+        hilos = max(1, cantidad);
+    }
+    
+    /**
+     * Carga los sudokus de entrada para comprobar que cada solución
+     * conserva sus pistas
+     */
+    void cargarEntrada(const string& archivo) {
+        LectorSudokus lector;
+        lector.leerArchivoPlano(archivo, [&](const TableroPlano& sudoku) {
+            if (sudoku.tamano > 0) {
+                size_t celdas = (size_t)sudoku.tamano * sudoku.tamano;
+                entradas[string(sudoku.etiqueta)].emplace_back(sudoku.celdas, sudoku.celdas + celdas);
+            }
+        });
+        conEntrada = true;
+    }
+    
+    ResumenLote validarArchivo(const string& archivo) {
+        ResumenLote resumen;
+        vector<TareaValidacion> bloque;
+        bloque.reserve(TAMANO_BLOQUE);
+        
+        LectorSudokus lector;
+        lector.leerArchivoPlano(archivo, [&](const TableroPlano& sudoku) {
+            TareaValidacion tarea;
+            tarea.etiqueta = string(sudoku.etiqueta);
+            tarea.n = sudoku.n;
+            tarea.motivo = sudoku.motivo;
+            if (sudoku.tamano > 0) {
+                tarea.tablero.assign(sudoku.celdas, sudoku.celdas + (size_t)sudoku.tamano * sudoku.tamano);
+            }
+            
+            if (conEntrada) {
+                auto it = entradas.find(tarea.etiqueta);
+                if (it != entradas.end() && !it->second.empty()) {
+                    tarea.entrada = move(it->second.front());
+                    it->second.pop_front();
+                } else {
+                    tarea.sinEntrada = true;
+                }
+            }
+            
+            bloque.push_back(move(tarea));
+            if (bloque.size() == TAMANO_BLOQUE) {
+                procesarBloque(bloque, resumen);
+            }
+        });
+        
+        procesarBloque(bloque, resumen);
+        resumen.bytes = lector.obtenerBytesLeidos();
+        return resumen;
+    }
+};
+
+/**
+ * Modo por lotes: valida todos los sudokus de un archivo etiquetado
+ */
+int validarLote(const string& archivo, const string& archivoEntrada, int hilos) {
+    ValidadorLote validador;
+    validador.establecerHilos(hilos);
+    if (!archivoEntrada.empty()) {
+        validador.cargarEntrada(archivoEntrada);
+    }
+    
+    cout << "Validando " << archivo << "..." << endl;
+    auto inicio = chrono::high_resolution_clock::now();
+    ResumenLote resumen = validador.validarArchivo(archivo);
+    auto fin = chrono::high_resolution_clock::now();
+    double segundos = chrono::duration<double>(fin - inicio).count();
+    
+    cout << "\nTotal: " << resumen.total << endl;
+    cout << "Validos: " << resumen.validos << endl;
+    cout << "Incompletos: " << resumen.incompletos << endl;
+    cout << "Invalidos: " << resumen.invalidos << endl;
+    if (!archivoEntrada.empty()) {
+        cout << "Pistas alteradas: " << resumen.pistasAlteradas << endl;
+        cout << "Sin entrada: " << resumen.sinEntrada << endl;
+    }
+    cout << "Sin solucion: " << resumen.sinSolucion << endl;
+    if (resumen.tiempoAgotado > 0) {
+        cout << "Tiempo agotado: " << resumen.tiempoAgotado << endl;
+    }
+    double megabytes = resumen.bytes / (1024.0 * 1024.0);
+    cout << "Tiempo: " << fixed << setprecision(3) << segundos << " s ("
+         << setprecision(1) << (segundos > 0 ? megabytes / segundos : 0.0) << " MB/s)" << endl;
+    
+    bool todoValido = resumen.validos + resumen.sinSolucion + resumen.tiempoAgotado == resumen.total;
+    return todoValido ? 0 : 2;
+}
+
 /**
  * Función principal - Ejemplo de uso
+ *
+ * Uso: validar [archivo]
+ *      validar --lote soluciones.txt [--entrada sudokus_entrada.txt] [--hilos N]
  */
 int main(int argc, char* argv[]) {
     try {
         string archivoEntrada = "ejemplo_sudoku.txt";
+        string archivoLote;
+        string archivoPistas;
+        int hilos = 1;
+        
+        for (int i = 1; i < argc; i++) {
+            string argumento = argv[i];
+            if (argumento == "--lote" && i + 1 < argc) {
+                archivoLote = argv[++i];
+            } else if (argumento == "--entrada" && i + 1 < argc) {
+                archivoPistas = argv[++i];
+            } else if ((argumento == "--hilos" || argumento == "--threads") && i + 1 < argc) {
+                hilos = stoi(argv[++i]);
+                if (hilos <= 0) {
+                    hilos = max(1u, thread::hardware_concurrency());
+                }
+            } else {
+                // Si se proporciona un archivo como argumento
+                archivoEntrada = argumento;
+            }
+        }
         
-        // Si se proporciona un archivo como argumento
-        if (argc > 1) {
-            archivoEntrada = argv[1];
+        if (!archivoLote.empty()) {
+            return validarLote(archivoLote, archivoPistas, hilos);
         }
         
         // Crear validador y leer sudoku
@@ -1,144 +1,173 @@
 #include <iostream>
-#include <cmath>
 #include <vector>
+#include <string>
 #include <random>
-#include <ctime>
-#include <algorithm>
+#include <chrono>
 #include <iomanip>
-#include <set>
+#include <memory>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include "GeneradorSudokus.h"
+#include "EscritorSudokus.h"
+#include "FormatoBinario.h"
 
 using namespace std;
 
+// Writes uniquely-solvable puzzles in the labelled "k-Sudoku #i" format that
+// Resolver.cpp reads (binary .sdkb when the output name asks for it)
 class SudokuGenerator {
 private:
-    int n;  // Size of the Sudoku (n x n grid)
-    int subgridSize; // Size of the subgrids (e.g., for 9x9 grid, subgridSize = 3)
-    vector<vector<int>> grid; // Sudoku grid
-    random_device rd;
-    mt19937 gen;
+    static const int BLOCK_SIZE = 1024;  // Puzzles per thread between writes
+
+    int k;  // Box order (e.g., 3 for a 9x9 grid)
+    int threads;
+    long long nodeLimit;
+    int minimumClues = 0;
+    long long uniquenessChecks = 0;
 
 public:
-    SudokuGenerator(int size) : n(size), subgridSize(sqrt(size)), gen(rd()) {
-        grid.resize(n, vector<int>(n, 0)); // Initialize the grid with zeros
+    SudokuGenerator(int order, int threadCount, long long limit)
+        : k(order), threads(max(1, threadCount)), nodeLimit(limit) {}
+
+    void setMinimumClues(int clues) {
+        minimumClues = clues;
     }
 
-	// Helper function to print the grid
-	void printGrid() {
-		for (int i = 0; i < n; ++i) {
-			for (int j = 0; j < n; ++j) {
-				if (grid[i][j] == 0) {
-					cout << "--";  // Empty cell, represented by "--"
-				} else {
-					cout << grid[i][j];  // Print the number directly without spacing
-				}
-			}
-			cout << endl;
-		}
-	}
-
-    // Function to check if a number can be placed at position (row, col)
-    bool isValidPlacement(int row, int col, int num) {
-        for (int i = 0; i < n; ++i) {
-            if (grid[row][i] == num || grid[i][col] == num) {
-                return false;
-            }
+    // Generate 'count' puzzles in blocks: each thread fills a slice of the
+    // block with its own generator, then the block is written in order.
+    // Puzzle i only depends on (seed, i), so the file is the same for any
+    // number of threads.
+    long long generate(long long count, uint64_t seed, const string& output) {
+        // Created first so an unsupported size fails before touching the output
+        vector<unique_ptr<GeneradorSudokus>> generators;
+        for (int t = 0; t < threads; ++t) {
+            generators.emplace_back(new GeneradorSudokus(k, nodeLimit));
+            generators.back()->establecerPistasMinimas(minimumClues);
         }
 
-        int startRow = (row / subgridSize) * subgridSize;
-        int startCol = (col / subgridSize) * subgridSize;
-        for (int i = startRow; i < startRow + subgridSize; ++i) {
-            for (int j = startCol; j < startCol + subgridSize; ++j) {
-                if (grid[i][j] == num) {
-                    return false;
-                }
-            }
+        unique_ptr<EscritorSudokus> writer;
+        bool binary = output.size() >= 5 && output.compare(output.size() - 5, 5, ".sdkb") == 0;
+        if (binary) {
+            writer.reset(new EscritorBinario(output));
+        } else {
+            writer.reset(new EscritorTexto(output));
         }
-        return true;
-    }
 
-    // Function to fill the diagonal subgrids with random values
-    void fillDiagonalSubgrids() {
-        for (int subgridIndex = 0; subgridIndex < n; subgridIndex += subgridSize) {
-            set<int> usedNumbers;
-            for (int i = subgridIndex; i < subgridIndex + subgridSize; ++i) {
-                for (int j = subgridIndex; j < subgridIndex + subgridSize; ++j) {
-                    vector<int> availableNums;
-                    for (int num = 1; num <= n; ++num) {
-                        if (usedNumbers.find(num) == usedNumbers.end()) {
-                            availableNums.push_back(num);
-                        }
-                    }
-                    uniform_int_distribution<> dis(0, availableNums.size() - 1);
-                    int selectedNum = availableNums[dis(gen)];
-                    grid[i][j] = selectedNum;
-                    usedNumbers.insert(selectedNum);
-                }
-            }
-        }
-    }
+        long long blockSize = (long long)BLOCK_SIZE * threads;
+        vector<vector<int>> puzzles(min(count, blockSize));
+        vector<long long> clues(threads, 0);
 
-    // Function to swap cells randomly
-    void swapCells(int swapPercentage) {
-        vector<pair<int, int>> filledCells;
-        for (int i = 0; i < n; ++i) {
-            for (int j = 0; j < n; ++j) {
-                if (grid[i][j] != 0) {
-                    filledCells.push_back({i, j});
+        for (long long first = 0; first < count; first += blockSize) {
+            long long size = min(blockSize, count - first);
+            atomic<long long> next(0);
+
+            auto worker = [&](int t) {
+                for (long long i = next++; i < size; i = next++) {
+                    uint64_t puzzleSeed = GeneradorSudokus::semillaDe(seed, first + i);
+                    clues[t] += generators[t]->generar(puzzleSeed, puzzles[i]);
                 }
+            };
+
+            vector<thread> workers;
+            for (int t = 1; t < threads; ++t) {
+                workers.emplace_back(worker, t);
             }
-        }
-        shuffle(filledCells.begin(), filledCells.end(), gen);
-
-        int numCellsToSwap = filledCells.size() * swapPercentage / 100;
-        uniform_int_distribution<> dis(0, filledCells.size() - 1);
-
-        for (int swapCount = 0; swapCount < numCellsToSwap; ++swapCount) {
-            int idx1 = swapCount;
-            int row1 = filledCells[idx1].first;
-            int col1 = filledCells[idx1].second;
-
-            vector<pair<int, int>> emptyCells;
-            for (int i = 0; i < n; ++i) {
-                for (int j = 0; j < n; ++j) {
-                    if (grid[i][j] == 0) {
-                        emptyCells.push_back({i, j});
-                    }
-                }
+            worker(0);
+            for (auto& w : workers) {
+                w.join();
             }
 
-            if (emptyCells.empty()) return;
+            for (long long i = 0; i < size; ++i) {
+                string label = to_string(k) + "-Sudoku #" + to_string(first + i + 1);
+                writer->escribir(label, puzzles[i].data(), k);
+            }
 
-            int idx2 = dis(gen) % emptyCells.size();
-            int row2 = emptyCells[idx2].first;
-            int col2 = emptyCells[idx2].second;
+            if (count > blockSize) {
+                cerr << "\rGenerated " << first + size << "/" << count << flush;
+            }
+        }
+        if (count > blockSize) {
+            cerr << endl;
+        }
+        writer->cerrar();
 
-            swap(grid[row1][col1], grid[row2][col2]);
+        long long totalClues = 0;
+        for (int t = 0; t < threads; ++t) {
+            totalClues += clues[t];
+            uniquenessChecks += generators[t]->obtenerComprobaciones();
         }
+        return totalClues;
     }
 
-    // Generate the Sudoku puzzle
-    void generate(int swapPercentage = 50) {
-        fillDiagonalSubgrids();
-        swapCells(swapPercentage);
-
-        // Only one final output
-        cout << "Generated Sudoku Puzzle:\n";
-        printGrid();
+    long long getUniquenessChecks() const {
+        return uniquenessChecks;
     }
 };
 
-int main() {
-    int k;
-    cout << "Enter a number (e.g., 3 for a 9x9 grid, 4 for a 16x16 grid): ";
-    cin >> k;
-
-    int n = k * k;
+// Usage: sudoku-nxn-gen [k] [count] [output] [--seed S] [--clues N] [--node-limit N] [--threads N]
+// Without arguments the box order is asked for interactively
+int main(int argc, char* argv[]) {
+    int k = 0;
+    long long count = 1;
+    int threads = 1;
+    string output = "sudokus_generados.txt";
+    uint64_t seed = random_device()();
+    int minimumClues = 0;
+    long long nodeLimit = -1;
 
     try {
-        SudokuGenerator generator(n);
-        generator.generate(50);
-    } catch (const invalid_argument& e) {
+        vector<string> positional;
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg == "--seed" && i + 1 < argc) {
+                seed = stoull(argv[++i]);
+            } else if (arg == "--clues" && i + 1 < argc) {
+                // Stop removing clues at this many givens (0 = minimal puzzle)
+                minimumClues = stoi(argv[++i]);
+            } else if ((arg == "--threads" || arg == "--hilos") && i + 1 < argc) {
+                // 0 = one thread per core
+                threads = stoi(argv[++i]);
+                if (threads == 0) threads = thread::hardware_concurrency();
+            } else if (arg == "--node-limit" && i + 1 < argc) {
+                // Cap for each uniqueness check; a check that hits it keeps the clue
+                nodeLimit = stoll(argv[++i]);
+            } else {
+                positional.push_back(arg);
+            }
+        }
+
+        if (positional.size() > 0) k = stoi(positional[0]);
+        if (positional.size() > 1) count = stoll(positional[1]);
+        if (positional.size() > 2) output = positional[2];
+
+        if (k == 0) {
+            cout << "Enter a number (e.g., 3 for a 9x9 grid, 4 for a 16x16 grid): ";
+            cin >> k;
+        }
+
+        // Uniqueness checks on 25x25 boards can blow up without a cap
+        if (nodeLimit < 0) {
+            nodeLimit = k >= 5 ? 2000 : 0;
+        }
+
+        SudokuGenerator generator(k, threads, nodeLimit);
+        generator.setMinimumClues(minimumClues);
+
+        auto start = chrono::steady_clock::now();
+        long long totalClues = generator.generate(count, seed, output);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << "Generated " << count << " " << k * k << "x" << k * k << " puzzles in " << output
+             << " (seed " << seed << ")" << endl;
+        cout << "Average clues: " << fixed << setprecision(1) << (count > 0 ? (double)totalClues / count : 0.0)
+             << ", uniqueness checks: " << generator.getUniquenessChecks() << endl;
+        cout << "Time: " << setprecision(3) << seconds << " s ("
+             << setprecision(0) << (seconds > 0 ? count / seconds : 0.0) << " puzzles/s)" << endl;
+    } catch (const exception& e) {
         cout << e.what() << endl;
+        return 1;
     }
 
     return 0;